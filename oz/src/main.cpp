@@ -33,42 +33,36 @@ int main() {
     Shader fragShader = device.createShader("default.frag", ShaderStage::Fragment);
 
     // create vertex buffer
-    Buffer vertStageBuffer = device.createBuffer(BufferType::Staging, vertBufferSize, vertices.data());
-    Buffer vertexBuffer    = device.createBuffer(BufferType::Vertex, vertBufferSize);
-    device.copyBuffer(vertStageBuffer, vertexBuffer, vertBufferSize);
-    device.free(vertStageBuffer);
+    Buffer vertexBuffer = device.createBuffer(BufferType::Vertex, vertBufferSize);
+    device.uploadBuffer(vertexBuffer, vertices.data(), vertBufferSize);
 
     // create index buffer
-    Buffer idxStageBuffer = device.createBuffer(BufferType::Staging, idxBufferSize, indices.data());
-    Buffer indexBuffer    = device.createBuffer(BufferType::Index, idxBufferSize);
-    device.copyBuffer(idxStageBuffer, indexBuffer, idxBufferSize);
-    device.free(idxStageBuffer);
+    Buffer indexBuffer = device.createBuffer(BufferType::Index, idxBufferSize);
+    device.uploadBuffer(indexBuffer, indices.data(), idxBufferSize);
 
-    // create uniform buffers
-    Buffer mvpBuffer   = device.createBuffer(BufferType::Uniform, sizeof(MVP));
-    Buffer countBuffer = device.createBuffer(BufferType::Uniform, sizeof(uint32_t));
-    Buffer numBuffer   = device.createBuffer(BufferType::Uniform, sizeof(uint32_t));
+    // uniform data is allocated every frame from the device uniform ring
+    Buffer uniformRing = device.getUniformRing();
 
     // Create descriptor set layouts
     DescriptorSetLayout mvpLayout = device.createDescriptorSetLayout(DescriptorSetLayoutInfo({
-        DescriptorSetLayoutBindingInfo(BindingType::Uniform),
+        DescriptorSetLayoutBindingInfo(BindingType::UniformDynamic),
     }));
 
     DescriptorSetLayout countLayout = device.createDescriptorSetLayout(DescriptorSetLayoutInfo({
-        DescriptorSetLayoutBindingInfo(BindingType::Uniform),
-        DescriptorSetLayoutBindingInfo(BindingType::Uniform),
+        DescriptorSetLayoutBindingInfo(BindingType::UniformDynamic),
+        DescriptorSetLayoutBindingInfo(BindingType::UniformDynamic),
     }));
 
     // Create descriptor sets
     DescriptorSet mvpSet = device.createDescriptorSet(mvpLayout,
                                                       DescriptorSetInfo({
-                                                          DescriptorSetBindingInfo(DescriptorSetBufferInfo(mvpBuffer, sizeof(MVP))),
+                                                          DescriptorSetBindingInfo(DescriptorSetBufferInfo(uniformRing, sizeof(MVP))),
                                                       }));
 
     DescriptorSet countSet = device.createDescriptorSet(countLayout,
                                                         DescriptorSetInfo({
-                                                            DescriptorSetBindingInfo(DescriptorSetBufferInfo(countBuffer, sizeof(uint32_t))),
-                                                            DescriptorSetBindingInfo(DescriptorSetBufferInfo(numBuffer, sizeof(uint32_t))),
+                                                            DescriptorSetBindingInfo(DescriptorSetBufferInfo(uniformRing, sizeof(uint32_t))),
+                                                            DescriptorSetBindingInfo(DescriptorSetBufferInfo(uniformRing, sizeof(uint32_t))),
                                                         }));
 
     // create render pass
@@ -83,13 +77,29 @@ int main() {
     device.free(mvpLayout);
     device.free(countLayout);
 
+    // draw packets, sorted by state before recording
+    RenderQueue renderQueue;
+
+    DrawPacket quad;
+    quad.pipeline     = renderPass;
+    quad.material     = mvpSet;
+    quad.vertexBuffer = vertexBuffer;
+    quad.indexBuffer  = indexBuffer;
+    quad.count        = indices.size();
+
     uint32_t frameCount = 0;
     uint32_t num   = 1;
     // render loop
     while (device.isWindowOpen(window)) {
+        // input is sampled right before the frame in flight is predicted to become available
+        device.paceFrame();
+        device.pollEvents();
+
         uint32_t      imageIndex = device.getCurrentImage(window);
         CommandBuffer cmd        = device.getCurrentCommandBuffer();
         uint32_t      frame      = device.getCurrentFrame();
+        uint32_t      countOffset;
+        uint32_t      numOffset;
 
         // update ubo
         {
@@ -101,39 +111,35 @@ int main() {
             mvp.view  = glm::lookAt(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
             mvp.proj  = glm::perspective(glm::radians(45.0f), 800 / (float)600, 0.1f, 10.0f);
             mvp.proj[1][1] *= -1;
-            device.updateBuffer(mvpBuffer, &mvp, sizeof(mvp));
-            device.updateBuffer(countBuffer, &frameCount, sizeof(frameCount));
-            device.updateBuffer(numBuffer, &num, sizeof(num));
+            quad.materialOffset = device.pushUniform(mvp);
+            countOffset         = device.pushUniform(frameCount);
+            numOffset           = device.pushUniform(num);
         }
 
         device.beginCmd(cmd);
         device.beginRenderPass(cmd, renderPass, imageIndex);
-        device.bindVertexBuffer(cmd, vertexBuffer);
-        device.bindIndexBuffer(cmd, indexBuffer);
-        device.bindDescriptorSet(cmd, renderPass, mvpSet, 0);
-        device.bindDescriptorSet(cmd, renderPass, countSet, 1);
+        device.bindDescriptorSet(cmd, renderPass, countSet, 1, {countOffset, numOffset});
 
-        device.drawIndexed(cmd, indices.size());
+        renderQueue.clear();
+        renderQueue.push(0, 0.5f, quad);
+        renderQueue.sort();
+        renderQueue.record(device, cmd);
         device.endRenderPass(cmd);
         device.endCmd(cmd);
 
         device.submitCmd(cmd);
-        device.presentImage(window, imageIndex);
+        device.presentFrame();
 
         frameCount++;
     }
-    device.waitIdle();
 
-    // free resources
+    // free resources, destruction is deferred until the GPU is done with them
     device.free(vertShader);
     device.free(fragShader);
     device.free(window);
     device.free(renderPass);
     device.free(vertexBuffer);
     device.free(indexBuffer);
-    device.free(mvpBuffer);
-    device.free(countBuffer);
-    device.free(numBuffer);
 
     return 0;
 }
\ No newline at end of file
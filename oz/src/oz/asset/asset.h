@@ -0,0 +1,5 @@
+#pragma once
+
+#include "oz/asset/importer.h"
+#include "oz/asset/mesh.h"
+#include "oz/asset/mesh_cache.h"
\ No newline at end of file
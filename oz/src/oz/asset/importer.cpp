@@ -0,0 +1,638 @@
+#include "oz/asset/importer.h"
+#include "oz/asset/json.h"
+#include "oz/core/file/file.h"
+#include "oz/core/job/job_system.h"
+
+#include <cstring>
+
+namespace oz::asset {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+static double getSecondsSince(Clock::time_point start) { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+// OBJ
+
+// text below this size is parsed on the calling thread only
+static constexpr uint32_t MIN_OBJ_CHUNK_SIZE = 256 * 1024;
+
+// indices of one face corner, -1 for a missing attribute
+struct ObjCorner {
+    int32_t position = -1;
+    int32_t uv       = -1;
+    int32_t normal   = -1;
+    uint8_t relative = 0; // bit per attribute, negative references are resolved once the chunk offsets are known
+};
+
+static constexpr uint8_t RELATIVE_POSITION = 1 << 0;
+static constexpr uint8_t RELATIVE_UV       = 1 << 1;
+static constexpr uint8_t RELATIVE_NORMAL   = 1 << 2;
+
+struct ObjChunk {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> uvs;
+    std::vector<glm::vec3> normals;
+    std::vector<ObjCorner> corners;     // three per triangle
+    std::vector<uint32_t>  groupStarts; // corner counts at which a new submesh starts
+};
+
+static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+static bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+static const char* skipBlanks(const char* p, const char* end) {
+    while (p != end && isBlank(*p)) {
+        p++;
+    }
+    return p;
+}
+
+static const char* parseFloat(const char* p, const char* end, float& result) {
+    static constexpr double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+
+    p = skipBlanks(p, end);
+
+    bool isNegative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        isNegative = *p == '-';
+        p++;
+    }
+
+    double value = 0.0;
+    while (p != end && isDigit(*p)) {
+        value = value * 10.0 + (*p++ - '0');
+    }
+
+    if (p != end && *p == '.') {
+        p++;
+        uint64_t fraction      = 0;
+        uint32_t fractionDigits = 0;
+        while (p != end && isDigit(*p)) {
+            // digits past double precision do not change the value
+            if (fractionDigits < 18) {
+                fraction = fraction * 10 + (*p - '0');
+                fractionDigits++;
+            }
+            p++;
+        }
+        value += fraction / POWERS_OF_TEN[fractionDigits];
+    }
+
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool isExponentNegative = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            isExponentNegative = *p == '-';
+            p++;
+        }
+        int exponent = 0;
+        while (p != end && isDigit(*p)) {
+            exponent = exponent * 10 + (*p++ - '0');
+        }
+        value *= std::pow(10.0, isExponentNegative ? -exponent : exponent);
+    }
+
+    result = static_cast<float>(isNegative ? -value : value);
+    return p;
+}
+
+static const char* parseInt(const char* p, const char* end, int32_t& result) {
+    bool isNegative = false;
+    if (p != end && (*p == '-' || *p == '+')) {
+        isNegative = *p == '-';
+        p++;
+    }
+
+    int32_t value = 0;
+    while (p != end && isDigit(*p)) {
+        value = value * 10 + (*p++ - '0');
+    }
+
+    result = isNegative ? -value : value;
+    return p;
+}
+
+// OBJ indices are 1-based, negative ones count back from the latest element
+static void resolveObjIndex(int32_t index, uint32_t localCount, uint8_t relativeBit, int32_t& value, uint8_t& relative) {
+    if (index > 0) {
+        value = index - 1;
+    } else if (index < 0) {
+        value = static_cast<int32_t>(localCount) + index;
+        relative |= relativeBit;
+    } else {
+        throw std::runtime_error("Invalid OBJ index!");
+    }
+}
+
+static void parseObjChunk(const char* begin, const char* end, ObjChunk& chunk) {
+    std::vector<ObjCorner> polygon;
+
+    const char* p = begin;
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+
+        p = skipBlanks(p, lineEnd);
+        if (lineEnd - p >= 2 && p[0] == 'v' && isBlank(p[1])) {
+            glm::vec3 position;
+            p = parseFloat(p + 1, lineEnd, position.x);
+            p = parseFloat(p, lineEnd, position.y);
+            p = parseFloat(p, lineEnd, position.z);
+            chunk.positions.push_back(position);
+        } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isBlank(p[2])) {
+            glm::vec2 uv;
+            p = parseFloat(p + 2, lineEnd, uv.x);
+            p = parseFloat(p, lineEnd, uv.y);
+            uv.y = 1.0f - uv.y; // OBJ puts the texture origin at the bottom left
+            chunk.uvs.push_back(uv);
+        } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2])) {
+            glm::vec3 normal;
+            p = parseFloat(p + 2, lineEnd, normal.x);
+            p = parseFloat(p, lineEnd, normal.y);
+            p = parseFloat(p, lineEnd, normal.z);
+            chunk.normals.push_back(normal);
+        } else if (lineEnd - p >= 2 && p[0] == 'f' && isBlank(p[1])) {
+            polygon.clear();
+            p = skipBlanks(p + 1, lineEnd);
+            while (p != lineEnd && (isDigit(*p) || *p == '-' || *p == '+')) {
+                ObjCorner corner;
+                int32_t   index;
+
+                p = parseInt(p, lineEnd, index);
+                resolveObjIndex(index, static_cast<uint32_t>(chunk.positions.size()), RELATIVE_POSITION, corner.position, corner.relative);
+                if (p != lineEnd && *p == '/') {
+                    p++;
+                    if (p != lineEnd && *p != '/') {
+                        p = parseInt(p, lineEnd, index);
+                        resolveObjIndex(index, static_cast<uint32_t>(chunk.uvs.size()), RELATIVE_UV, corner.uv, corner.relative);
+                    }
+                    if (p != lineEnd && *p == '/') {
+                        p = parseInt(p + 1, lineEnd, index);
+                        resolveObjIndex(index, static_cast<uint32_t>(chunk.normals.size()), RELATIVE_NORMAL, corner.normal, corner.relative);
+                    }
+                }
+                polygon.push_back(corner);
+                p = skipBlanks(p, lineEnd);
+            }
+
+            // fan triangulation
+            for (size_t i = 2; i < polygon.size(); i++) {
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i - 1]);
+                chunk.corners.push_back(polygon[i]);
+            }
+        } else if (p != lineEnd && (std::strncmp(p, "usemtl", std::min<size_t>(6, lineEnd - p)) == 0 || *p == 'o' || *p == 'g') &&
+                   lineEnd - p >= 2) {
+            chunk.groupStarts.push_back(static_cast<uint32_t>(chunk.corners.size()));
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+// GLB
+
+static constexpr uint32_t GLB_MAGIC      = 0x46546C67; // "glTF"
+static constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+static constexpr uint32_t GLB_CHUNK_BIN  = 0x004E4942;
+
+static constexpr uint32_t GLTF_UNSIGNED_BYTE  = 5121;
+static constexpr uint32_t GLTF_UNSIGNED_SHORT = 5123;
+static constexpr uint32_t GLTF_UNSIGNED_INT   = 5125;
+static constexpr uint32_t GLTF_FLOAT          = 5126;
+static constexpr uint32_t GLTF_TRIANGLES      = 4;
+
+struct GltfAccessor {
+    const char* data           = nullptr;
+    uint32_t    count          = 0;
+    uint32_t    stride         = 0;
+    uint32_t    componentType  = 0;
+    uint32_t    componentCount = 0; // of the accessor type, the range is validated for elements of this size
+};
+
+static uint32_t getGltfComponentSize(uint32_t componentType) {
+    switch (componentType) {
+    case GLTF_UNSIGNED_BYTE: return 1;
+    case GLTF_UNSIGNED_SHORT: return 2;
+    case GLTF_UNSIGNED_INT:
+    case GLTF_FLOAT: return 4;
+    default: throw std::runtime_error("Not supported glTF component type!");
+    }
+}
+
+static uint32_t getGltfComponentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    throw std::runtime_error("Not supported glTF accessor type!");
+}
+
+static GltfAccessor getGltfAccessor(const JsonValue& document, uint32_t accessorIndex, const char* bin, size_t binSize) {
+    const JsonValue* accessors   = document.find("accessors");
+    const JsonValue* bufferViews = document.find("bufferViews");
+    if (accessors == nullptr || bufferViews == nullptr || accessorIndex >= accessors->array.size()) {
+        throw std::runtime_error("Invalid glTF accessor!");
+    }
+
+    const JsonValue& accessor       = accessors->array[accessorIndex];
+    const JsonValue* bufferViewIndex = accessor.find("bufferView");
+    if (bufferViewIndex == nullptr || bufferViewIndex->asUint() >= bufferViews->array.size()) {
+        throw std::runtime_error("Not supported glTF accessor without buffer view!");
+    }
+    const JsonValue& bufferView = bufferViews->array[bufferViewIndex->asUint()];
+
+    const JsonValue* type          = accessor.find("type");
+    const JsonValue* componentType = accessor.find("componentType");
+    const JsonValue* count         = accessor.find("count");
+    if (type == nullptr || componentType == nullptr || count == nullptr) {
+        throw std::runtime_error("Invalid glTF accessor!");
+    }
+
+    GltfAccessor result;
+    result.componentType  = componentType->asUint();
+    result.componentCount = getGltfComponentCount(type->string);
+    result.count          = count->asUint();
+
+    uint32_t elementSize = getGltfComponentSize(result.componentType) * result.componentCount;
+    const JsonValue* byteStride = bufferView.find("byteStride");
+    result.stride               = byteStride != nullptr ? byteStride->asUint() : elementSize;
+
+    // the binary chunk is buffer 0, external buffers are not supported
+    const JsonValue* buffer = bufferView.find("buffer");
+    if (buffer == nullptr || buffer->asUint() != 0) {
+        throw std::runtime_error("Not supported glTF external buffer!");
+    }
+
+    uint64_t offset = uint64_t(bufferView.find("byteOffset") ? bufferView.find("byteOffset")->asUint() : 0) +
+                      (accessor.find("byteOffset") ? accessor.find("byteOffset")->asUint() : 0);
+    uint64_t size   = result.count == 0 ? 0 : uint64_t(result.count - 1) * result.stride + elementSize;
+    if (offset + size > binSize) {
+        throw std::runtime_error("Invalid glTF accessor range!");
+    }
+    result.data = bin + offset;
+
+    return result;
+}
+
+template <typename T>
+static void readGltfAttribute(const GltfAccessor& accessor, std::vector<MeshVertex>& vertices, T MeshVertex::*member) {
+    // a whole T is copied per element, e.g. 3 floats for positions, so a smaller type would read past the validated range
+    if (accessor.componentType != GLTF_FLOAT || accessor.componentCount != sizeof(T) / sizeof(float)) {
+        throw std::runtime_error("Not supported glTF attribute format!");
+    }
+    if (accessor.count != vertices.size()) {
+        throw std::runtime_error("Invalid glTF attribute count!");
+    }
+
+    for (uint32_t i = 0; i < accessor.count; i++) {
+        std::memcpy(&(vertices[i].*member), accessor.data + uint64_t(i) * accessor.stride, sizeof(T));
+    }
+}
+
+static void readGltfIndices(const GltfAccessor& accessor, std::vector<uint32_t>& indices) {
+    indices.resize(accessor.count);
+    for (uint32_t i = 0; i < accessor.count; i++) {
+        const char* element = accessor.data + uint64_t(i) * accessor.stride;
+        switch (accessor.componentType) {
+        case GLTF_UNSIGNED_BYTE: indices[i] = static_cast<uint8_t>(*element); break;
+        case GLTF_UNSIGNED_SHORT: {
+            uint16_t index;
+            std::memcpy(&index, element, sizeof(index));
+            indices[i] = index;
+            break;
+        }
+        case GLTF_UNSIGNED_INT: std::memcpy(&indices[i], element, sizeof(uint32_t)); break;
+        default: throw std::runtime_error("Not supported glTF index format!");
+        }
+    }
+}
+
+static std::string getExtension(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos) {
+        return "";
+    }
+
+    std::string extension = path.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+} // namespace
+
+MeshData parseObj(const char* data, size_t size, uint32_t threadCount) {
+    // split the text at line boundaries
+    std::vector<const char*> chunkStarts = {data};
+    {
+        if (threadCount == 0) {
+            threadCount = job::getJobSystem().getWorkerCount();
+        }
+        size_t chunkCount = std::clamp<size_t>(size / MIN_OBJ_CHUNK_SIZE, 1, threadCount);
+        for (size_t chunk = 1; chunk < chunkCount; chunk++) {
+            const char* start   = std::max(data + size * chunk / chunkCount, chunkStarts.back());
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', data + size - start));
+            if (newline == nullptr) {
+                break;
+            }
+            chunkStarts.push_back(newline + 1);
+        }
+        chunkStarts.push_back(data + size);
+    }
+
+    const uint32_t        chunkCount = static_cast<uint32_t>(chunkStarts.size() - 1);
+    std::vector<ObjChunk> chunks(chunkCount);
+    job::getJobSystem().parallelFor(chunkCount, 1, chunkCount, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t chunk = begin; chunk < end; chunk++) {
+            parseObjChunk(chunkStarts[chunk], chunkStarts[chunk + 1], chunks[chunk]);
+        }
+    });
+
+    // global offsets of every chunk
+    std::vector<ObjChunk> merged(1);
+    ObjChunk&             all = merged[0];
+    {
+        size_t positionCount = 0, uvCount = 0, normalCount = 0, cornerCount = 0;
+        for (const ObjChunk& chunk : chunks) {
+            positionCount += chunk.positions.size();
+            uvCount += chunk.uvs.size();
+            normalCount += chunk.normals.size();
+            cornerCount += chunk.corners.size();
+        }
+        all.positions.reserve(positionCount);
+        all.uvs.reserve(uvCount);
+        all.normals.reserve(normalCount);
+        all.corners.reserve(cornerCount);
+    }
+
+    for (ObjChunk& chunk : chunks) {
+        const int32_t  positionBase = static_cast<int32_t>(all.positions.size());
+        const int32_t  uvBase       = static_cast<int32_t>(all.uvs.size());
+        const int32_t  normalBase   = static_cast<int32_t>(all.normals.size());
+        const uint32_t cornerBase   = static_cast<uint32_t>(all.corners.size());
+
+        for (ObjCorner& corner : chunk.corners) {
+            corner.position += (corner.relative & RELATIVE_POSITION) ? positionBase : 0;
+            corner.uv += (corner.relative & RELATIVE_UV) ? uvBase : 0;
+            corner.normal += (corner.relative & RELATIVE_NORMAL) ? normalBase : 0;
+        }
+        for (uint32_t groupStart : chunk.groupStarts) {
+            all.groupStarts.push_back(cornerBase + groupStart);
+        }
+
+        all.positions.insert(all.positions.end(), chunk.positions.begin(), chunk.positions.end());
+        all.uvs.insert(all.uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+        all.normals.insert(all.normals.end(), chunk.normals.begin(), chunk.normals.end());
+        all.corners.insert(all.corners.end(), chunk.corners.begin(), chunk.corners.end());
+        chunk = ObjChunk();
+    }
+
+    // one vertex per distinct position/uv/normal triple
+    MeshData mesh;
+    {
+        const uint32_t cornerCount = static_cast<uint32_t>(all.corners.size());
+
+        uint32_t tableSize = 1;
+        while (tableSize < cornerCount * 2) {
+            tableSize <<= 1;
+        }
+        std::vector<uint32_t> table(tableSize, std::numeric_limits<uint32_t>::max());
+        std::vector<uint32_t> vertexCorners; // first corner of every vertex, to compare keys
+        vertexCorners.reserve(cornerCount / 2);
+
+        mesh.indices.resize(cornerCount);
+        mesh.vertices.reserve(cornerCount / 2);
+
+        for (uint32_t c = 0; c < cornerCount; c++) {
+            const ObjCorner& corner = all.corners[c];
+            if (corner.position < 0 || corner.position >= static_cast<int32_t>(all.positions.size()) ||
+                corner.uv >= static_cast<int32_t>(all.uvs.size()) || corner.normal >= static_cast<int32_t>(all.normals.size()) || corner.uv < -1 ||
+                corner.normal < -1) {
+                throw std::runtime_error("Invalid OBJ index!");
+            }
+
+            uint64_t hash = (uint64_t(uint32_t(corner.position)) * 0x9E3779B97F4A7C15ull) ^ (uint64_t(uint32_t(corner.uv)) * 0xC2B2AE3D27D4EB4Full) ^
+                            (uint64_t(uint32_t(corner.normal)) * 0x165667B19E3779F9ull);
+            uint32_t slot = static_cast<uint32_t>(hash ^ (hash >> 32)) & (tableSize - 1);
+            while (table[slot] != std::numeric_limits<uint32_t>::max()) {
+                const ObjCorner& other = all.corners[vertexCorners[table[slot]]];
+                if (other.position == corner.position && other.uv == corner.uv && other.normal == corner.normal) {
+                    break;
+                }
+                slot = (slot + 1) & (tableSize - 1);
+            }
+
+            if (table[slot] == std::numeric_limits<uint32_t>::max()) {
+                table[slot] = static_cast<uint32_t>(mesh.vertices.size());
+                vertexCorners.push_back(c);
+
+                MeshVertex vertex;
+                vertex.position = all.positions[corner.position];
+                vertex.uv       = corner.uv >= 0 ? all.uvs[corner.uv] : glm::vec2(0.0f);
+                vertex.normal   = corner.normal >= 0 ? all.normals[corner.normal] : glm::vec3(0.0f);
+                mesh.vertices.push_back(vertex);
+            }
+            mesh.indices[c] = table[slot];
+        }
+    }
+
+    // submeshes between the group starts, empty groups are skipped
+    {
+        std::vector<uint32_t> boundaries = {0};
+        boundaries.insert(boundaries.end(), all.groupStarts.begin(), all.groupStarts.end());
+        boundaries.push_back(static_cast<uint32_t>(mesh.indices.size()));
+
+        for (size_t i = 0; i + 1 < boundaries.size(); i++) {
+            if (boundaries[i + 1] > boundaries[i]) {
+                mesh.submeshes.push_back({boundaries[i], boundaries[i + 1] - boundaries[i]});
+            }
+        }
+    }
+
+    computeBounds(mesh);
+    return mesh;
+}
+
+MeshData parseGlb(const char* data, size_t size, uint32_t threadCount) {
+    // header and chunks
+    const char* json     = nullptr;
+    size_t      jsonSize = 0;
+    const char* bin      = nullptr;
+    size_t      binSize  = 0;
+    {
+        uint32_t header[3];
+        if (size < sizeof(header)) {
+            throw std::runtime_error("Invalid GLB file!");
+        }
+        std::memcpy(header, data, sizeof(header));
+        if (header[0] != GLB_MAGIC || header[1] != 2 || header[2] > size) {
+            throw std::runtime_error("Invalid GLB file!");
+        }
+
+        size_t offset = sizeof(header);
+        while (offset + 8 <= header[2]) {
+            uint32_t chunkHeader[2];
+            std::memcpy(chunkHeader, data + offset, sizeof(chunkHeader));
+            offset += sizeof(chunkHeader);
+            if (offset + chunkHeader[0] > header[2]) {
+                throw std::runtime_error("Invalid GLB chunk!");
+            }
+
+            if (chunkHeader[1] == GLB_CHUNK_JSON && json == nullptr) {
+                json     = data + offset;
+                jsonSize = chunkHeader[0];
+            } else if (chunkHeader[1] == GLB_CHUNK_BIN && bin == nullptr) {
+                bin     = data + offset;
+                binSize = chunkHeader[0];
+            }
+            offset += chunkHeader[0];
+        }
+
+        if (json == nullptr) {
+            throw std::runtime_error("Invalid GLB file!");
+        }
+    }
+
+    JsonValue document = parseJson(json, json + jsonSize);
+
+    // every triangle primitive becomes a submesh
+    std::vector<const JsonValue*> primitives;
+    if (const JsonValue* meshes = document.find("meshes")) {
+        for (const JsonValue& mesh : meshes->array) {
+            const JsonValue* meshPrimitives = mesh.find("primitives");
+            if (meshPrimitives == nullptr) {
+                continue;
+            }
+            for (const JsonValue& primitive : meshPrimitives->array) {
+                const JsonValue* mode = primitive.find("mode");
+                if (mode == nullptr || mode->asUint() == GLTF_TRIANGLES) {
+                    primitives.push_back(&primitive);
+                }
+            }
+        }
+    }
+
+    // primitives are decoded in parallel
+    std::vector<MeshData> parts(primitives.size());
+    job::getJobSystem().parallelFor(static_cast<uint32_t>(primitives.size()), 1, threadCount, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t p = begin; p < end; p++) {
+            const JsonValue& primitive  = *primitives[p];
+            const JsonValue* attributes = primitive.find("attributes");
+            const JsonValue* position   = attributes ? attributes->find("POSITION") : nullptr;
+            if (position == nullptr) {
+                throw std::runtime_error("Not supported glTF primitive without positions!");
+            }
+
+            MeshData&    part              = parts[p];
+            GltfAccessor positionAccessor = getGltfAccessor(document, position->asUint(), bin, binSize);
+            part.vertices.resize(positionAccessor.count, MeshVertex{glm::vec3(0.0f), glm::vec3(0.0f), glm::vec2(0.0f)});
+            readGltfAttribute(positionAccessor, part.vertices, &MeshVertex::position);
+
+            if (const JsonValue* normal = attributes->find("NORMAL")) {
+                readGltfAttribute(getGltfAccessor(document, normal->asUint(), bin, binSize), part.vertices, &MeshVertex::normal);
+            }
+            if (const JsonValue* uv = attributes->find("TEXCOORD_0")) {
+                readGltfAttribute(getGltfAccessor(document, uv->asUint(), bin, binSize), part.vertices, &MeshVertex::uv);
+            }
+
+            if (const JsonValue* indices = primitive.find("indices")) {
+                readGltfIndices(getGltfAccessor(document, indices->asUint(), bin, binSize), part.indices);
+            } else {
+                part.indices.resize(part.vertices.size());
+                for (uint32_t i = 0; i < part.indices.size(); i++) {
+                    part.indices[i] = i;
+                }
+            }
+        }
+    });
+
+    MeshData mesh;
+    for (MeshData& part : parts) {
+        const uint32_t baseVertex = static_cast<uint32_t>(mesh.vertices.size());
+        const uint32_t firstIndex = static_cast<uint32_t>(mesh.indices.size());
+
+        for (uint32_t index : part.indices) {
+            if (index >= part.vertices.size()) {
+                throw std::runtime_error("Invalid glTF index!");
+            }
+            mesh.indices.push_back(baseVertex + index);
+        }
+        mesh.vertices.insert(mesh.vertices.end(), part.vertices.begin(), part.vertices.end());
+        mesh.submeshes.push_back({firstIndex, static_cast<uint32_t>(part.indices.size())});
+
+        part = MeshData();
+    }
+
+    computeBounds(mesh);
+    return mesh;
+}
+
+MeshData importObj(const std::string& path, const ImportSettings& settings, ImportStats* stats) {
+    ImportStats importStats;
+
+    Clock::time_point start = Clock::now();
+    std::vector<char> source = file::readFile(path);
+    importStats.readSeconds = getSecondsSince(start);
+    importStats.sourceSize  = source.size();
+
+    start                    = Clock::now();
+    MeshData mesh            = parseObj(source.data(), source.size(), settings.threadCount);
+    importStats.parseSeconds = getSecondsSince(start);
+
+    start = Clock::now();
+    if (settings.optimize) {
+        processMesh(mesh, settings.threadCount);
+    }
+    if (settings.generateLods) {
+        generateLods(mesh, settings.lodSettings, settings.threadCount);
+    }
+    importStats.optimizeSeconds = getSecondsSince(start);
+
+    if (stats != nullptr) {
+        *stats = importStats;
+    }
+    return mesh;
+}
+
+MeshData importGlb(const std::string& path, const ImportSettings& settings, ImportStats* stats) {
+    ImportStats importStats;
+
+    Clock::time_point start = Clock::now();
+    std::vector<char> source = file::readFile(path);
+    importStats.readSeconds = getSecondsSince(start);
+    importStats.sourceSize  = source.size();
+
+    start                    = Clock::now();
+    MeshData mesh            = parseGlb(source.data(), source.size(), settings.threadCount);
+    importStats.parseSeconds = getSecondsSince(start);
+
+    start = Clock::now();
+    if (settings.optimize) {
+        processMesh(mesh, settings.threadCount);
+    }
+    if (settings.generateLods) {
+        generateLods(mesh, settings.lodSettings, settings.threadCount);
+    }
+    importStats.optimizeSeconds = getSecondsSince(start);
+
+    if (stats != nullptr) {
+        *stats = importStats;
+    }
+    return mesh;
+}
+
+MeshData importMesh(const std::string& path, const ImportSettings& settings, ImportStats* stats) {
+    std::string extension = getExtension(path);
+    if (extension == ".obj") {
+        return importObj(path, settings, stats);
+    }
+    if (extension == ".glb") {
+        return importGlb(path, settings, stats);
+    }
+    throw std::runtime_error("Not supported mesh format: " + path);
+}
+
+} // namespace oz::asset
\ No newline at end of file
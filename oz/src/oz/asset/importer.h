@@ -0,0 +1,40 @@
+#pragma once
+
+#include "oz/asset/mesh.h"
+#include "oz/asset/simplify.h"
+
+#include <string>
+
+namespace oz::asset {
+
+struct ImportSettings {
+    uint32_t    threadCount  = 0;    // most jobs the import is split into, 0 lets the job system pick
+    bool        optimize     = true; // deduplicate and reorder for vertex cache and fetch locality
+    bool        generateLods = true; // simplified index ranges per submesh, see generateLods
+    LodSettings lodSettings;
+};
+
+// timings of one import, source bytes over the total time gives the import throughput
+struct ImportStats {
+    uint64_t sourceSize      = 0;
+    double   readSeconds     = 0.0;
+    double   parseSeconds    = 0.0;
+    double   optimizeSeconds = 0.0;
+    bool     isCacheHit      = false; // set by loadMesh when the source was not parsed
+
+    double getTotalSeconds() const { return readSeconds + parseSeconds + optimizeSeconds; }
+    double getMegabytesPerSecond() const { return getTotalSeconds() > 0.0 ? sourceSize / (1024.0 * 1024.0) / getTotalSeconds() : 0.0; }
+};
+
+// Wavefront OBJ, polygons are triangulated as fans, every usemtl/o/g starts a new submesh
+MeshData importObj(const std::string& path, const ImportSettings& settings = {}, ImportStats* stats = nullptr);
+// glTF 2.0 binary, every triangle primitive of every mesh becomes a submesh, node transforms are not applied
+MeshData importGlb(const std::string& path, const ImportSettings& settings = {}, ImportStats* stats = nullptr);
+// picks the importer by file extension
+MeshData importMesh(const std::string& path, const ImportSettings& settings = {}, ImportStats* stats = nullptr);
+
+// parsing only, for data that is already in memory
+MeshData parseObj(const char* data, size_t size, uint32_t threadCount = 0);
+MeshData parseGlb(const char* data, size_t size, uint32_t threadCount = 0);
+
+} // namespace oz::asset
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "oz/asset/json.h"
+
+#include <cstdlib>
+
+namespace oz::asset {
+
+namespace {
+
+class JsonParser {
+  public:
+    JsonParser(const char* begin, const char* end) : m_current(begin), m_end(end) {}
+
+    JsonValue parseDocument() {
+        JsonValue value = parseValue();
+        skipWhitespace();
+        if (m_current != m_end) {
+            fail();
+        }
+        return value;
+    }
+
+  private:
+    [[noreturn]] void fail() const { throw std::runtime_error("Invalid JSON!"); }
+
+    void skipWhitespace() {
+        while (m_current != m_end && (*m_current == ' ' || *m_current == '\t' || *m_current == '\n' || *m_current == '\r')) {
+            m_current++;
+        }
+    }
+
+    void expect(char c) {
+        skipWhitespace();
+        if (m_current == m_end || *m_current != c) {
+            fail();
+        }
+        m_current++;
+    }
+
+    bool consumeLiteral(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (static_cast<size_t>(m_end - m_current) < length || std::strncmp(m_current, literal, length) != 0) {
+            return false;
+        }
+        m_current += length;
+        return true;
+    }
+
+    JsonValue parseValue() {
+        skipWhitespace();
+        if (m_current == m_end) {
+            fail();
+        }
+
+        JsonValue value;
+        switch (*m_current) {
+        case '{':
+            value.type = JsonValue::Type::Object;
+            m_current++;
+            skipWhitespace();
+            if (m_current != m_end && *m_current == '}') {
+                m_current++;
+                break;
+            }
+            do {
+                skipWhitespace();
+                std::string key = parseString();
+                expect(':');
+                value.object.emplace_back(std::move(key), parseValue());
+                skipWhitespace();
+            } while (m_current != m_end && *m_current == ',' && ++m_current);
+            expect('}');
+            break;
+        case '[':
+            value.type = JsonValue::Type::Array;
+            m_current++;
+            skipWhitespace();
+            if (m_current != m_end && *m_current == ']') {
+                m_current++;
+                break;
+            }
+            do {
+                value.array.push_back(parseValue());
+                skipWhitespace();
+            } while (m_current != m_end && *m_current == ',' && ++m_current);
+            expect(']');
+            break;
+        case '"':
+            value.type   = JsonValue::Type::String;
+            value.string = parseString();
+            break;
+        case 't':
+        case 'f':
+            value.type    = JsonValue::Type::Bool;
+            value.boolean = *m_current == 't';
+            if (!consumeLiteral(value.boolean ? "true" : "false")) {
+                fail();
+            }
+            break;
+        case 'n':
+            if (!consumeLiteral("null")) {
+                fail();
+            }
+            break;
+        default: {
+            // strtod needs a terminated string, numbers are short so copy them out
+            char        buffer[64];
+            const char* start = m_current;
+            while (m_current != m_end && std::strchr("+-0123456789.eE", *m_current) != nullptr) {
+                m_current++;
+            }
+            size_t length = m_current - start;
+            if (length == 0 || length >= sizeof(buffer)) {
+                fail();
+            }
+            std::memcpy(buffer, start, length);
+            buffer[length] = '\0';
+
+            value.type   = JsonValue::Type::Number;
+            value.number = std::strtod(buffer, nullptr);
+            break;
+        }
+        }
+
+        return value;
+    }
+
+    std::string parseString() {
+        if (m_current == m_end || *m_current != '"') {
+            fail();
+        }
+        m_current++;
+
+        std::string result;
+        while (m_current != m_end && *m_current != '"') {
+            char c = *m_current++;
+            if (c != '\\') {
+                result.push_back(c);
+                continue;
+            }
+
+            if (m_current == m_end) {
+                fail();
+            }
+            char escaped = *m_current++;
+            switch (escaped) {
+            case 'n': result.push_back('\n'); break;
+            case 't': result.push_back('\t'); break;
+            case 'r': result.push_back('\r'); break;
+            case 'b': result.push_back('\b'); break;
+            case 'f': result.push_back('\f'); break;
+            case 'u':
+                // glTF keys are ascii, code points are kept as a placeholder
+                if (m_end - m_current < 4) {
+                    fail();
+                }
+                m_current += 4;
+                result.push_back('?');
+                break;
+            default: result.push_back(escaped); break;
+            }
+        }
+        if (m_current == m_end) {
+            fail();
+        }
+        m_current++;
+
+        return result;
+    }
+
+  private:
+    const char* m_current;
+    const char* m_end;
+};
+
+} // namespace
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    for (const auto& [name, value] : object) {
+        if (name == key) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+JsonValue parseJson(const char* begin, const char* end) { return JsonParser(begin, end).parseDocument(); }
+
+} // namespace oz::asset
\ No newline at end of file
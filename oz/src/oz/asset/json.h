@@ -0,0 +1,31 @@
+#pragma once
+
+#include "oz/common.h"
+
+#include <string>
+
+namespace oz::asset {
+
+// Minimal JSON document, enough to read glTF headers.
+struct JsonValue {
+    enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+    Type                                           type    = Type::Null;
+    bool                                           boolean = false;
+    double                                         number  = 0.0;
+    std::string                                    string;
+    std::vector<JsonValue>                         array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    // returns nullptr if this is not an object or the key is missing
+    const JsonValue* find(const std::string& key) const;
+
+    uint32_t asUint(uint32_t fallback = 0) const { return type == Type::Number ? static_cast<uint32_t>(number) : fallback; }
+    bool     isArray() const { return type == Type::Array; }
+    bool     isObject() const { return type == Type::Object; }
+};
+
+// throws on malformed input
+JsonValue parseJson(const char* begin, const char* end);
+
+} // namespace oz::asset
\ No newline at end of file
@@ -0,0 +1,288 @@
+#include "oz/asset/mesh.h"
+#include "oz/core/job/job_system.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace oz::asset {
+
+namespace {
+
+static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+// Forsyth scoring constants, tuned for a 32 entry cache
+static constexpr uint32_t CACHE_SIZE          = 32;
+static constexpr float    CACHE_DECAY_POWER   = 1.5f;
+static constexpr float    LAST_TRIANGLE_SCORE = 0.75f;
+static constexpr float    VALENCE_BOOST_SCALE = 2.0f;
+static constexpr float    VALENCE_BOOST_POWER = 0.5f;
+static constexpr uint32_t MAX_VALENCE_TABLE   = 64;
+
+struct ScoreTables {
+    float cache[CACHE_SIZE];
+    float valence[MAX_VALENCE_TABLE];
+
+    ScoreTables() {
+        for (uint32_t i = 0; i < CACHE_SIZE; i++) {
+            // the last triangle's vertices get a fixed score so that strips are not favored over fans
+            cache[i] = i < 3 ? LAST_TRIANGLE_SCORE : std::pow(1.0f - float(i - 3) / float(CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        for (uint32_t i = 0; i < MAX_VALENCE_TABLE; i++) {
+            valence[i] = i == 0 ? 0.0f : VALENCE_BOOST_SCALE * std::pow(float(i), -VALENCE_BOOST_POWER);
+        }
+    }
+};
+
+static const ScoreTables s_scoreTables;
+
+static float getVertexScore(int32_t cachePosition, uint32_t valence) {
+    // vertices without remaining triangles do not matter anymore
+    if (valence == 0) {
+        return -1.0f;
+    }
+
+    float score = cachePosition >= 0 ? s_scoreTables.cache[cachePosition] : 0.0f;
+    score += valence < MAX_VALENCE_TABLE ? s_scoreTables.valence[valence] : VALENCE_BOOST_SCALE * std::pow(float(valence), -VALENCE_BOOST_POWER);
+
+    return score;
+}
+
+// reorders the triangles of indices in place, vertex indices are rebased to [baseVertex, baseVertex + vertexCount)
+static void optimizeTriangles(uint32_t* indices, uint32_t indexCount, uint32_t baseVertex, uint32_t vertexCount) {
+    const uint32_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) {
+        return;
+    }
+
+    // triangle adjacency of every vertex
+    std::vector<uint32_t> valences(vertexCount, 0);
+    for (uint32_t i = 0; i < indexCount; i++) {
+        valences[indices[i] - baseVertex]++;
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + valences[v];
+    }
+
+    std::vector<uint32_t> adjacency(indexCount);
+    {
+        std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < indexCount; i++) {
+            adjacency[cursors[indices[i] - baseVertex]++] = i / 3;
+        }
+    }
+
+    // initial scores
+    std::vector<int32_t> cachePositions(vertexCount, -1);
+    std::vector<float>   vertexScores(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        vertexScores[v] = getVertexScore(-1, valences[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool>  isEmitted(triangleCount, false);
+    uint32_t           bestTriangle = 0;
+    for (uint32_t t = 0; t < triangleCount; t++) {
+        triangleScores[t] = vertexScores[indices[t * 3] - baseVertex] + vertexScores[indices[t * 3 + 1] - baseVertex] +
+                            vertexScores[indices[t * 3 + 2] - baseVertex];
+        if (triangleScores[t] > triangleScores[bestTriangle]) {
+            bestTriangle = t;
+        }
+    }
+
+    std::vector<uint32_t> output(indexCount);
+    uint32_t              cache[CACHE_SIZE + 3];
+    uint32_t              cacheCount   = 0;
+    uint32_t              scanPosition = 0;
+
+    for (uint32_t emitted = 0; emitted < triangleCount; emitted++) {
+        // no candidate in the cache, continue with the next triangle in the input order
+        if (bestTriangle == INVALID_INDEX) {
+            while (isEmitted[scanPosition]) {
+                scanPosition++;
+            }
+            bestTriangle = scanPosition;
+        }
+
+        uint32_t triangle[3] = {indices[bestTriangle * 3] - baseVertex,
+                                indices[bestTriangle * 3 + 1] - baseVertex,
+                                indices[bestTriangle * 3 + 2] - baseVertex};
+        std::memcpy(&output[emitted * 3], &indices[bestTriangle * 3], 3 * sizeof(uint32_t));
+        isEmitted[bestTriangle] = true;
+
+        // remove the triangle from the adjacency of its vertices
+        for (uint32_t v : triangle) {
+            uint32_t* begin = &adjacency[adjacencyOffsets[v]];
+            uint32_t* last  = begin + valences[v] - 1;
+            *std::find(begin, last + 1, bestTriangle) = *last;
+            valences[v]--;
+        }
+
+        // push the triangle's vertices to the front of the cache
+        uint32_t newCache[CACHE_SIZE + 3];
+        uint32_t newCacheCount = 0;
+        for (uint32_t v : triangle) {
+            newCache[newCacheCount++] = v;
+        }
+        for (uint32_t i = 0; i < cacheCount; i++) {
+            uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                newCache[newCacheCount++] = v;
+            }
+        }
+
+        // rescore the vertices that moved or dropped out of the cache and their remaining triangles
+        bestTriangle    = INVALID_INDEX;
+        float bestScore = -1.0f;
+        for (uint32_t i = 0; i < newCacheCount; i++) {
+            uint32_t v        = newCache[i];
+            cachePositions[v] = i < CACHE_SIZE ? static_cast<int32_t>(i) : -1;
+
+            float score = getVertexScore(cachePositions[v], valences[v]);
+            float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + valences[v]; a++) {
+                uint32_t t = adjacency[a];
+                triangleScores[t] += delta;
+            }
+        }
+        for (uint32_t i = 0; i < std::min(newCacheCount, CACHE_SIZE); i++) {
+            uint32_t v = newCache[i];
+            for (uint32_t a = adjacencyOffsets[v]; a < adjacencyOffsets[v] + valences[v]; a++) {
+                uint32_t t = adjacency[a];
+                if (triangleScores[t] > bestScore) {
+                    bestScore    = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCacheCount, CACHE_SIZE);
+        std::memcpy(cache, newCache, cacheCount * sizeof(uint32_t));
+    }
+
+    std::memcpy(indices, output.data(), indexCount * sizeof(uint32_t));
+}
+
+static uint64_t hashVertex(const MeshVertex& vertex) {
+    static_assert(sizeof(MeshVertex) % sizeof(uint32_t) == 0);
+
+    uint32_t words[sizeof(MeshVertex) / sizeof(uint32_t)];
+    std::memcpy(words, &vertex, sizeof(MeshVertex));
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint32_t word : words) {
+        hash = (hash ^ word) * 0x100000001b3ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+} // namespace
+
+void deduplicateVertices(MeshData& mesh) {
+    const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+
+    // open addressing table of unique vertex indices, at most half full
+    uint32_t tableSize = 1;
+    while (tableSize < vertexCount * 2) {
+        tableSize <<= 1;
+    }
+    std::vector<uint32_t> table(tableSize, INVALID_INDEX);
+
+    std::vector<uint32_t>   remap(vertexCount);
+    std::vector<MeshVertex> uniqueVertices;
+    uniqueVertices.reserve(vertexCount);
+
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        const MeshVertex& vertex = mesh.vertices[v];
+
+        uint32_t slot = static_cast<uint32_t>(hashVertex(vertex)) & (tableSize - 1);
+        while (table[slot] != INVALID_INDEX && std::memcmp(&uniqueVertices[table[slot]], &vertex, sizeof(MeshVertex)) != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if (table[slot] == INVALID_INDEX) {
+            table[slot] = static_cast<uint32_t>(uniqueVertices.size());
+            uniqueVertices.push_back(vertex);
+        }
+        remap[v] = table[slot];
+    }
+
+    for (uint32_t& index : mesh.indices) {
+        index = remap[index];
+    }
+    mesh.vertices = std::move(uniqueVertices);
+}
+
+void optimizeVertexCache(MeshData& mesh, uint32_t threadCount) {
+    // index ranges are independent, every one is reordered within itself
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    ranges.reserve(mesh.submeshes.size() + mesh.lods.size());
+    for (const Submesh& submesh : mesh.submeshes) {
+        ranges.emplace_back(submesh.firstIndex, submesh.indexCount);
+    }
+    for (const MeshLod& lod : mesh.lods) {
+        ranges.emplace_back(lod.firstIndex, lod.indexCount);
+    }
+
+    job::getJobSystem().parallelFor(static_cast<uint32_t>(ranges.size()), 1, threadCount, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t r = begin; r < end; r++) {
+            if (ranges[r].second > 0) {
+                optimizeVertexCache(&mesh.indices[ranges[r].first], ranges[r].second);
+            }
+        }
+    });
+}
+
+void optimizeVertexCache(uint32_t* indices, uint32_t indexCount) {
+    if (indexCount == 0) {
+        return;
+    }
+
+    auto [minV, maxV]   = std::minmax_element(indices, indices + indexCount);
+    uint32_t baseVertex = *minV;
+    optimizeTriangles(indices, indexCount, baseVertex, *maxV - baseVertex + 1);
+}
+
+void optimizeVertexFetch(MeshData& mesh) {
+    std::vector<uint32_t> remap(mesh.vertices.size(), INVALID_INDEX);
+
+    std::vector<MeshVertex> orderedVertices;
+    orderedVertices.reserve(mesh.vertices.size());
+
+    // unreferenced vertices are dropped
+    for (uint32_t& index : mesh.indices) {
+        if (remap[index] == INVALID_INDEX) {
+            remap[index] = static_cast<uint32_t>(orderedVertices.size());
+            orderedVertices.push_back(mesh.vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    mesh.vertices = std::move(orderedVertices);
+}
+
+void computeBounds(MeshData& mesh) {
+    if (mesh.vertices.empty()) {
+        mesh.boundsMin = mesh.boundsMax = glm::vec3(0.0f);
+        return;
+    }
+
+    mesh.boundsMin = mesh.boundsMax = mesh.vertices[0].position;
+    for (const MeshVertex& vertex : mesh.vertices) {
+        mesh.boundsMin = glm::min(mesh.boundsMin, vertex.position);
+        mesh.boundsMax = glm::max(mesh.boundsMax, vertex.position);
+    }
+}
+
+void processMesh(MeshData& mesh, uint32_t threadCount) {
+    deduplicateVertices(mesh);
+    optimizeVertexCache(mesh, threadCount);
+    optimizeVertexFetch(mesh);
+    computeBounds(mesh);
+}
+
+} // namespace oz::asset
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "oz/common.h"
+
+namespace oz::asset {
+
+// interleaved vertex, uploaded as is to a vertex buffer
+struct MeshVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+};
+
+// coarser index range of a submesh, drawn with the same vertex buffer as the full detail range
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float    error      = 0.0f; // object space distance to the full detail surface
+};
+
+// index range of one material or primitive
+struct Submesh {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t firstLod   = 0; // coarser levels in MeshData::lods, ordered from fine to coarse
+    uint32_t lodCount   = 0;
+};
+
+// Processed triangle mesh. vertices and indices are laid out for createBuffer, indices are 32-bit (IndexType::Uint32).
+struct MeshData {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t>   indices;
+    std::vector<Submesh>    submeshes;
+    std::vector<MeshLod>    lods; // index ranges after the ones of the submeshes
+    glm::vec3               boundsMin = glm::vec3(0.0f);
+    glm::vec3               boundsMax = glm::vec3(0.0f);
+
+    uint64_t getVertexDataSize() const { return vertices.size() * sizeof(MeshVertex); }
+    uint64_t getIndexDataSize() const { return indices.size() * sizeof(uint32_t); }
+};
+
+// merges bitwise identical vertices and remaps the indices
+void deduplicateVertices(MeshData& mesh);
+// reorders the triangles of every submesh and lod for post-transform vertex cache hits (Forsyth, linear speed)
+void optimizeVertexCache(MeshData& mesh, uint32_t threadCount = 0);
+void optimizeVertexCache(uint32_t* indices, uint32_t indexCount);
+// renumbers the vertices in the order they are first referenced, so vertex fetches walk memory forwards
+void optimizeVertexFetch(MeshData& mesh);
+void computeBounds(MeshData& mesh);
+
+// all of the above in order
+void processMesh(MeshData& mesh, uint32_t threadCount = 0);
+
+} // namespace oz::asset
\ No newline at end of file
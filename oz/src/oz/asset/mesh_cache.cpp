@@ -0,0 +1,117 @@
+#include "oz/asset/mesh_cache.h"
+
+#include <cstring>
+
+namespace oz::asset {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+static uint64_t alignOffset(uint64_t offset) { return (offset + MESH_CACHE_ALIGNMENT - 1) & ~uint64_t(MESH_CACHE_ALIGNMENT - 1); }
+
+static bool isRangeValid(uint64_t offset, uint64_t size, uint64_t fileSize) {
+    return offset % MESH_CACHE_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+}
+
+} // namespace
+
+std::optional<MappedMesh> MappedMesh::open(const std::string& path, uint64_t sourceHash) {
+    if (!file::exists(path)) {
+        return std::nullopt;
+    }
+
+    MappedMesh mesh;
+    mesh.m_file = file::MappedFile(path);
+    if (mesh.m_file.size() < sizeof(MeshCacheHeader)) {
+        return std::nullopt;
+    }
+
+    // header checks only, the blobs are used as they are
+    const MeshCacheHeader* header = reinterpret_cast<const MeshCacheHeader*>(mesh.m_file.data());
+    if (header->magic != MESH_CACHE_MAGIC || header->version != MESH_CACHE_VERSION || header->sourceHash != sourceHash ||
+        header->fileSize != mesh.m_file.size() || header->vertexStride != sizeof(MeshVertex)) {
+        return std::nullopt;
+    }
+    if (!isRangeValid(header->vertexOffset, uint64_t(header->vertexCount) * sizeof(MeshVertex), header->fileSize) ||
+        !isRangeValid(header->indexOffset, uint64_t(header->indexCount) * sizeof(uint32_t), header->fileSize) ||
+        !isRangeValid(header->submeshOffset, uint64_t(header->submeshCount) * sizeof(Submesh), header->fileSize) ||
+        !isRangeValid(header->lodOffset, uint64_t(header->lodCount) * sizeof(MeshLod), header->fileSize)) {
+        return std::nullopt;
+    }
+
+    mesh.m_header = header;
+    return mesh;
+}
+
+uint64_t getMeshSourceHash(const std::string& sourcePath, const ImportSettings& settings) {
+    uint64_t sourceHash = file::hashFile(sourcePath);
+
+    // thread count does not change the output
+    uint64_t lodKey = 0;
+    if (settings.generateLods) {
+        const LodSettings& lod = settings.lodSettings;
+        lodKey                 = file::hash(&lod.maxLodCount, sizeof(lod.maxLodCount));
+        lodKey                 = file::hash(&lod.reduction, sizeof(lod.reduction), lodKey);
+        lodKey                 = file::hash(&lod.maxError, sizeof(lod.maxError), lodKey);
+    }
+
+    const uint64_t key[] = {sourceHash, MESH_CACHE_VERSION, settings.optimize ? 1ull : 0ull, lodKey};
+    return file::hash(key, sizeof(key));
+}
+
+void writeMeshCache(const std::string& path, const MeshData& mesh, uint64_t sourceHash) {
+    MeshCacheHeader header = {};
+    header.magic           = MESH_CACHE_MAGIC;
+    header.version         = MESH_CACHE_VERSION;
+    header.sourceHash      = sourceHash;
+    header.vertexStride    = sizeof(MeshVertex);
+    header.vertexCount     = static_cast<uint32_t>(mesh.vertices.size());
+    header.indexCount      = static_cast<uint32_t>(mesh.indices.size());
+    header.submeshCount    = static_cast<uint32_t>(mesh.submeshes.size());
+    header.lodCount        = static_cast<uint32_t>(mesh.lods.size());
+    header.vertexOffset    = alignOffset(sizeof(MeshCacheHeader));
+    header.indexOffset     = alignOffset(header.vertexOffset + mesh.getVertexDataSize());
+    header.submeshOffset   = alignOffset(header.indexOffset + mesh.getIndexDataSize());
+    header.lodOffset       = alignOffset(header.submeshOffset + mesh.submeshes.size() * sizeof(Submesh));
+    header.fileSize        = header.lodOffset + mesh.lods.size() * sizeof(MeshLod);
+    std::memcpy(header.boundsMin, &mesh.boundsMin, sizeof(header.boundsMin));
+    std::memcpy(header.boundsMax, &mesh.boundsMax, sizeof(header.boundsMax));
+
+    // padding stays zero, so equal meshes produce equal files
+    std::vector<char> data(header.fileSize, 0);
+    std::memcpy(data.data(), &header, sizeof(header));
+    std::memcpy(data.data() + header.vertexOffset, mesh.vertices.data(), mesh.getVertexDataSize());
+    std::memcpy(data.data() + header.indexOffset, mesh.indices.data(), mesh.getIndexDataSize());
+    std::memcpy(data.data() + header.submeshOffset, mesh.submeshes.data(), mesh.submeshes.size() * sizeof(Submesh));
+    std::memcpy(data.data() + header.lodOffset, mesh.lods.data(), mesh.lods.size() * sizeof(MeshLod));
+
+    file::writeFile(path, data.data(), data.size());
+}
+
+MappedMesh loadMesh(const std::string& sourcePath, const std::string& cachePath, const ImportSettings& settings, ImportStats* stats) {
+    const std::string path       = cachePath.empty() ? sourcePath + ".ozmesh" : cachePath;
+    const uint64_t    sourceHash = getMeshSourceHash(sourcePath, settings);
+
+    Clock::time_point          start = Clock::now();
+    std::optional<MappedMesh> mesh  = MappedMesh::open(path, sourceHash);
+    if (mesh.has_value()) {
+        if (stats != nullptr) {
+            *stats             = {};
+            stats->isCacheHit  = true;
+            stats->readSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        return std::move(mesh.value());
+    }
+
+    // stale or missing
+    writeMeshCache(path, importMesh(sourcePath, settings, stats), sourceHash);
+
+    mesh = MappedMesh::open(path, sourceHash);
+    if (!mesh.has_value()) {
+        throw std::runtime_error("Failed to load mesh cache: " + path);
+    }
+    return std::move(mesh.value());
+}
+
+} // namespace oz::asset
\ No newline at end of file
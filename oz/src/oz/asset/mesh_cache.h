@@ -0,0 +1,78 @@
+#pragma once
+
+#include "oz/asset/importer.h"
+#include "oz/asset/mesh.h"
+#include "oz/core/file/file.h"
+
+namespace oz::asset {
+
+// bump on any change of the layout below or of the mesh processing, so existing caches rebuild
+static constexpr uint32_t MESH_CACHE_MAGIC     = 0x434D5A4F; // "OZMC"
+static constexpr uint32_t MESH_CACHE_VERSION   = 2;
+static constexpr uint32_t MESH_CACHE_ALIGNMENT = 64;
+
+// Binary mesh cache, little-endian. The header is followed by the vertex, index, submesh and lod blobs,
+// each starting at a MESH_CACHE_ALIGNMENT aligned offset from the start of the file.
+struct MeshCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash; // see getMeshSourceHash
+    uint64_t fileSize;
+
+    uint32_t vertexStride;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t submeshCount;
+    uint32_t lodCount;
+    uint32_t reserved;
+
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t submeshOffset;
+    uint64_t lodOffset;
+
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+// Processed mesh read from a memory-mapped cache file. The accessors point into the mapping,
+// pass them straight to GraphicsDevice::uploadBuffer to upload without an intermediate copy.
+class MappedMesh final {
+  public:
+    // empty if the file is missing, invalid or was built from another source hash
+    static std::optional<MappedMesh> open(const std::string& path, uint64_t sourceHash);
+
+  public:
+    const MeshVertex* getVertices() const { return reinterpret_cast<const MeshVertex*>(m_file.data() + m_header->vertexOffset); }
+    const uint32_t*   getIndices() const { return reinterpret_cast<const uint32_t*>(m_file.data() + m_header->indexOffset); }
+    const Submesh*    getSubmeshes() const { return reinterpret_cast<const Submesh*>(m_file.data() + m_header->submeshOffset); }
+    const MeshLod*    getLods() const { return reinterpret_cast<const MeshLod*>(m_file.data() + m_header->lodOffset); }
+
+    uint32_t getVertexCount() const { return m_header->vertexCount; }
+    uint32_t getIndexCount() const { return m_header->indexCount; }
+    uint32_t getSubmeshCount() const { return m_header->submeshCount; }
+    uint32_t getLodCount() const { return m_header->lodCount; }
+
+    uint64_t getVertexDataSize() const { return uint64_t(m_header->vertexCount) * sizeof(MeshVertex); }
+    uint64_t getIndexDataSize() const { return uint64_t(m_header->indexCount) * sizeof(uint32_t); }
+
+    glm::vec3 getBoundsMin() const { return glm::vec3(m_header->boundsMin[0], m_header->boundsMin[1], m_header->boundsMin[2]); }
+    glm::vec3 getBoundsMax() const { return glm::vec3(m_header->boundsMax[0], m_header->boundsMax[1], m_header->boundsMax[2]); }
+
+  private:
+    MappedMesh() = default;
+
+    file::MappedFile       m_file;
+    const MeshCacheHeader* m_header = nullptr;
+};
+
+// hash of the source file contents, the import settings that change the output and MESH_CACHE_VERSION
+uint64_t getMeshSourceHash(const std::string& sourcePath, const ImportSettings& settings = {});
+
+void writeMeshCache(const std::string& path, const MeshData& mesh, uint64_t sourceHash);
+
+// Maps the cache of a source mesh, importing the source and rewriting the cache first if it is missing or stale.
+// The cache is stored at cachePath, or next to the source with an .ozmesh extension if cachePath is empty.
+MappedMesh loadMesh(const std::string& sourcePath, const std::string& cachePath = "", const ImportSettings& settings = {}, ImportStats* stats = nullptr);
+
+} // namespace oz::asset
\ No newline at end of file
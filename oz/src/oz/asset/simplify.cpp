@@ -0,0 +1,331 @@
+#include "oz/asset/simplify.h"
+#include "oz/core/job/job_system.h"
+
+namespace oz::asset {
+
+namespace {
+
+// symmetric 4x4 matrix of the summed squared distances to a set of planes, weighted by triangle area
+struct Quadric {
+    double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+    double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+    double a22 = 0.0, a23 = 0.0;
+    double a33    = 0.0;
+    double weight = 0.0;
+
+    void addPlane(const glm::dvec3& n, double d, double w) {
+        a00 += w * n.x * n.x;
+        a01 += w * n.x * n.y;
+        a02 += w * n.x * n.z;
+        a03 += w * n.x * d;
+        a11 += w * n.y * n.y;
+        a12 += w * n.y * n.z;
+        a13 += w * n.y * d;
+        a22 += w * n.z * n.z;
+        a23 += w * n.z * d;
+        a33 += w * d * d;
+        weight += w;
+    }
+
+    Quadric& operator+=(const Quadric& other) {
+        a00 += other.a00;
+        a01 += other.a01;
+        a02 += other.a02;
+        a03 += other.a03;
+        a11 += other.a11;
+        a12 += other.a12;
+        a13 += other.a13;
+        a22 += other.a22;
+        a23 += other.a23;
+        a33 += other.a33;
+        weight += other.weight;
+        return *this;
+    }
+
+    // mean squared distance of p to the planes
+    double evaluate(const glm::vec3& p) const {
+        const double x = p.x, y = p.y, z = p.z;
+
+        double result = x * x * a00 + y * y * a11 + z * z * a22 + a33;
+        result += 2.0 * (x * y * a01 + x * z * a02 + y * z * a12);
+        result += 2.0 * (x * a03 + y * a13 + z * a23);
+
+        return weight > 0.0 ? std::abs(result) / weight : 0.0;
+    }
+};
+
+struct Collapse {
+    double   cost;
+    uint32_t from;
+    uint32_t to;
+};
+
+static glm::vec3 getTriangleNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2) { return glm::cross(p1 - p0, p2 - p0); }
+
+} // namespace
+
+float simplifyIndices(const MeshVertex*      vertices,
+                      const uint32_t*        indices,
+                      uint32_t               indexCount,
+                      uint32_t               targetIndexCount,
+                      float                  maxError,
+                      std::vector<uint32_t>& result) {
+    result.clear();
+    if (indexCount == 0) {
+        return 0.0f;
+    }
+
+    // work on local vertex indices in [0, vertexCount)
+    auto [minV, maxV]          = std::minmax_element(indices, indices + indexCount);
+    const uint32_t baseVertex  = *minV;
+    const uint32_t vertexCount = *maxV - baseVertex + 1;
+
+    std::vector<uint32_t> triangles(indices, indices + indexCount);
+    for (uint32_t& index : triangles) {
+        index -= baseVertex;
+    }
+
+    auto getPosition = [&](uint32_t v) -> const glm::vec3& { return vertices[baseVertex + v].position; };
+
+    // a directed edge without exactly as many opposite edges is on a border, a seam or non-manifold
+    std::vector<bool> isLocked(vertexCount, false);
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(indexCount);
+        for (uint32_t i = 0; i < indexCount; i += 3) {
+            for (uint32_t e = 0; e < 3; e++) {
+                edges.push_back((uint64_t(triangles[i + e]) << 32) | triangles[i + (e + 1) % 3]);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+
+        for (size_t i = 0; i < edges.size();) {
+            size_t end = i;
+            while (end < edges.size() && edges[end] == edges[i]) {
+                end++;
+            }
+
+            uint64_t opposite      = (edges[i] << 32) | (edges[i] >> 32);
+            auto     oppositeRange = std::equal_range(edges.begin(), edges.end(), opposite);
+            if (size_t(oppositeRange.second - oppositeRange.first) != end - i) {
+                isLocked[edges[i] >> 32]         = true;
+                isLocked[edges[i] & 0xFFFFFFFFu] = true;
+            }
+            i = end;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (uint32_t i = 0; i < indexCount; i += 3) {
+        const glm::dvec3 p0(getPosition(triangles[i]));
+        const glm::dvec3 p1(getPosition(triangles[i + 1]));
+        const glm::dvec3 p2(getPosition(triangles[i + 2]));
+
+        glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+        double     length = glm::length(normal);
+        if (length == 0.0) {
+            continue;
+        }
+        normal /= length;
+
+        Quadric plane;
+        plane.addPlane(normal, -glm::dot(normal, p0), length * 0.5);
+        for (uint32_t e = 0; e < 3; e++) {
+            quadrics[triangles[i + e]] += plane;
+        }
+    }
+
+    const double maxCost   = double(maxError) * double(maxError);
+    double       worstCost = 0.0;
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<bool>     isTouched(vertexCount);
+
+    // every pass collapses a set of edges whose neighborhoods do not overlap, cheapest first
+    while (triangles.size() > targetIndexCount) {
+        const uint32_t triangleCount = static_cast<uint32_t>(triangles.size() / 3);
+
+        // triangle adjacency of every vertex
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : triangles) {
+            adjacencyOffsets[index + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+        adjacency.resize(triangles.size());
+        {
+            std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t i = 0; i < triangles.size(); i++) {
+                adjacency[cursors[triangles[i]]++] = i / 3;
+            }
+        }
+
+        // cheaper direction of every edge, each interior edge is seen from both of its triangles
+        collapses.clear();
+        for (uint32_t i = 0; i < triangles.size(); i += 3) {
+            for (uint32_t e = 0; e < 3; e++) {
+                uint32_t a = triangles[i + e];
+                uint32_t b = triangles[i + (e + 1) % 3];
+                if (a > b && !isLocked[a] && !isLocked[b]) {
+                    continue;
+                }
+
+                Quadric quadric = quadrics[a];
+                quadric += quadrics[b];
+
+                double costToB = isLocked[a] ? std::numeric_limits<double>::max() : quadric.evaluate(getPosition(b));
+                double costToA = isLocked[b] ? std::numeric_limits<double>::max() : quadric.evaluate(getPosition(a));
+                if (costToB == std::numeric_limits<double>::max() && costToA == std::numeric_limits<double>::max()) {
+                    continue;
+                }
+                collapses.push_back(costToB <= costToA ? Collapse{costToB, a, b} : Collapse{costToA, b, a});
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        // an interior collapse removes two triangles
+        const uint32_t targetTriangleCount = targetIndexCount / 3;
+        const uint32_t maxCollapseCount    = std::max(1u, (triangleCount - targetTriangleCount + 1) / 2);
+        uint32_t       collapseCount       = 0;
+
+        std::fill(isTouched.begin(), isTouched.end(), false);
+        for (const Collapse& collapse : collapses) {
+            if (collapse.cost > maxCost || collapseCount >= maxCollapseCount) {
+                break;
+            }
+            if (isTouched[collapse.from] || isTouched[collapse.to]) {
+                continue;
+            }
+
+            // reject collapses that flip a remaining triangle
+            bool isFlipping = false;
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1] && !isFlipping; a++) {
+                const uint32_t* triangle = &triangles[adjacency[a] * 3];
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) {
+                    continue;
+                }
+
+                glm::vec3 positions[3] = {getPosition(triangle[0]), getPosition(triangle[1]), getPosition(triangle[2])};
+                glm::vec3 oldNormal    = getTriangleNormal(positions[0], positions[1], positions[2]);
+                for (uint32_t e = 0; e < 3; e++) {
+                    if (triangle[e] == collapse.from) {
+                        positions[e] = getPosition(collapse.to);
+                    }
+                }
+                glm::vec3 newNormal = getTriangleNormal(positions[0], positions[1], positions[2]);
+
+                isFlipping = glm::dot(oldNormal, newNormal) <= 0.0f;
+            }
+            if (isFlipping) {
+                continue;
+            }
+
+            // the neighborhood of the removed vertex changes, no other collapse of this pass may use it
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+                const uint32_t* triangle = &triangles[adjacency[a] * 3];
+                isTouched[triangle[0]]   = true;
+                isTouched[triangle[1]]   = true;
+                isTouched[triangle[2]]   = true;
+            }
+            for (uint32_t a = adjacencyOffsets[collapse.from]; a < adjacencyOffsets[collapse.from + 1]; a++) {
+                uint32_t* triangle = &triangles[adjacency[a] * 3];
+                for (uint32_t e = 0; e < 3; e++) {
+                    if (triangle[e] == collapse.from) {
+                        triangle[e] = collapse.to;
+                    }
+                }
+            }
+
+            quadrics[collapse.to] += quadrics[collapse.from];
+            worstCost = std::max(worstCost, collapse.cost);
+            collapseCount++;
+        }
+
+        if (collapseCount == 0) {
+            break;
+        }
+
+        // drop the triangles that became degenerate
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            uint32_t a = triangles[i], b = triangles[i + 1], c = triangles[i + 2];
+            if (a != b && b != c && a != c) {
+                triangles[writeIndex++] = a;
+                triangles[writeIndex++] = b;
+                triangles[writeIndex++] = c;
+            }
+        }
+        triangles.resize(writeIndex);
+    }
+
+    result.resize(triangles.size());
+    for (size_t i = 0; i < triangles.size(); i++) {
+        result[i] = triangles[i] + baseVertex;
+    }
+
+    return static_cast<float>(std::sqrt(worstCost));
+}
+
+void generateLods(MeshData& mesh, const LodSettings& settings, uint32_t threadCount) {
+    // drop the previous chain, its indices are after the ones of the submeshes
+    if (!mesh.lods.empty()) {
+        uint32_t lodIndexBegin = static_cast<uint32_t>(mesh.indices.size());
+        for (const MeshLod& lod : mesh.lods) {
+            lodIndexBegin = std::min(lodIndexBegin, lod.firstIndex);
+        }
+        mesh.indices.resize(lodIndexBegin);
+        mesh.lods.clear();
+    }
+
+    const float maxError = settings.maxError * glm::length(mesh.boundsMax - mesh.boundsMin);
+
+    struct LevelData {
+        std::vector<uint32_t> indices;
+        float                 error;
+    };
+    std::vector<std::vector<LevelData>> submeshLevels(mesh.submeshes.size());
+
+    job::getJobSystem().parallelFor(static_cast<uint32_t>(mesh.submeshes.size()), 1, threadCount, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t s = begin; s < end; s++) {
+            const Submesh&   submesh     = mesh.submeshes[s];
+            const uint32_t*  fullIndices = mesh.indices.data() + submesh.firstIndex;
+            uint32_t         prevCount   = submesh.indexCount;
+
+            for (uint32_t level = 0; level < settings.maxLodCount; level++) {
+                uint32_t targetCount = static_cast<uint32_t>(prevCount * settings.reduction) / 3 * 3;
+                if (targetCount < 3) {
+                    break;
+                }
+
+                // every level is simplified from the full detail range, so its error is measured against the original surface
+                LevelData levelData;
+                levelData.error = simplifyIndices(mesh.vertices.data(), fullIndices, submesh.indexCount, targetCount, maxError, levelData.indices);
+
+                // stop once locked vertices or the error bound keep the level from getting meaningfully smaller
+                if (levelData.indices.empty() || levelData.indices.size() > prevCount - (prevCount - targetCount) / 2) {
+                    break;
+                }
+
+                optimizeVertexCache(levelData.indices.data(), static_cast<uint32_t>(levelData.indices.size()));
+                prevCount = static_cast<uint32_t>(levelData.indices.size());
+                submeshLevels[s].push_back(std::move(levelData));
+            }
+        }
+    });
+
+    for (size_t s = 0; s < mesh.submeshes.size(); s++) {
+        Submesh& submesh = mesh.submeshes[s];
+        submesh.firstLod = static_cast<uint32_t>(mesh.lods.size());
+        submesh.lodCount = static_cast<uint32_t>(submeshLevels[s].size());
+
+        for (const LevelData& levelData : submeshLevels[s]) {
+            mesh.lods.push_back({static_cast<uint32_t>(mesh.indices.size()), static_cast<uint32_t>(levelData.indices.size()), levelData.error});
+            mesh.indices.insert(mesh.indices.end(), levelData.indices.begin(), levelData.indices.end());
+        }
+    }
+}
+
+} // namespace oz::asset
\ No newline at end of file
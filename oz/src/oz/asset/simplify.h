@@ -0,0 +1,27 @@
+#pragma once
+
+#include "oz/asset/mesh.h"
+
+namespace oz::asset {
+
+struct LodSettings {
+    uint32_t maxLodCount = 4;     // coarser levels per submesh
+    float    reduction   = 0.5f;  // index count of every level relative to the previous one
+    float    maxError    = 0.05f; // relative to the bounds diagonal, coarser levels are not generated
+};
+
+// Quadric error metric edge collapse. Vertices are only moved onto each other, never created, so the result indexes
+// the same vertices as the input. Vertices on borders and attribute seams are kept in place.
+// Returns the error of the result as object space distance, maxError is in the same unit.
+float simplifyIndices(const MeshVertex*      vertices,
+                      const uint32_t*        indices,
+                      uint32_t               indexCount,
+                      uint32_t               targetIndexCount,
+                      float                  maxError,
+                      std::vector<uint32_t>& result);
+
+// Replaces the lods of every submesh with a chain simplified from its full detail range.
+// The level indices are appended to mesh.indices and ordered for the vertex cache.
+void generateLods(MeshData& mesh, const LodSettings& settings = {}, uint32_t threadCount = 0);
+
+} // namespace oz::asset
\ No newline at end of file
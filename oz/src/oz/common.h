@@ -6,13 +6,17 @@
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <initializer_list>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <set>
+#include <span>
 #include <stdexcept>
+#include <tuple>
 #include <vector>
 
 #define GLM_FORCE_RADIANS
@@ -1,3 +1,6 @@
 #pragma once
 
-#include "oz/core/file/file.h"
\ No newline at end of file
+#include "oz/core/file/file.h"
+#include "oz/core/job/job_system.h"
+#include "oz/core/memory/handle_pool.h"
+#include "oz/core/memory/inline_vector.h"
\ No newline at end of file
@@ -1,15 +1,23 @@
 #include "oz/core/file/file.h"
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
+#include <utility>
 
 #if defined(_WIN32)
 #include <windows.h>
-#elif defined(__linux__)
-#include <limits.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <limits.h>
 #elif defined(__APPLE__)
 #include <mach-o/dyld.h>
 #endif
+#endif
 
 namespace oz::file {
 
@@ -29,6 +37,152 @@ std::vector<char> readFile(const std::string &filename) {
     return buffer;
 }
 
+void writeFile(const std::string &filename, const void *data, size_t size) {
+    // write next to the target and rename, so a reader never sees a partially written file
+    std::string tempFilename = filename + ".tmp";
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("failed to open file: " + tempFilename);
+        }
+
+        file.write(static_cast<const char *>(data), size);
+        if (!file) {
+            throw std::runtime_error("failed to write file: " + tempFilename);
+        }
+    }
+
+    std::remove(filename.c_str());
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0) {
+        throw std::runtime_error("failed to write file: " + filename);
+    }
+}
+
+bool exists(const std::string &filename) { return std::ifstream(filename).good(); }
+
+uint64_t hash(const void *data, size_t size, uint64_t seed) {
+    static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+    static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+
+    const char *bytes = static_cast<const char *>(data);
+    uint64_t result   = seed ^ (size * PRIME_1);
+
+    // 8 bytes per step, the tail is zero padded
+    size_t offset = 0;
+    for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, 8);
+        result ^= (word * PRIME_2);
+        result = ((result << 31) | (result >> 33)) * PRIME_1;
+    }
+    if (offset < size) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes + offset, size - offset);
+        result ^= (word * PRIME_2);
+        result = ((result << 31) | (result >> 33)) * PRIME_1;
+    }
+
+    // final avalanche
+    result ^= result >> 33;
+    result *= PRIME_2;
+    result ^= result >> 29;
+    return result;
+}
+
+uint64_t hashFile(const std::string &filename) {
+    MappedFile file(filename);
+    return hash(file.data(), file.size());
+}
+
+MappedFile::MappedFile(const std::string &filename) {
+#if defined(_WIN32)
+    m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        throw std::runtime_error("failed to open file: " + filename);
+    }
+
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(m_file, &fileSize);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    if (m_size == 0) {
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr) {
+        m_data = static_cast<const char *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (m_data == nullptr) {
+        close();
+        throw std::runtime_error("failed to map file: " + filename);
+    }
+#else
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("failed to open file: " + filename);
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        throw std::runtime_error("failed to open file: " + filename);
+    }
+
+    m_size = static_cast<size_t>(fileStat.st_size);
+    if (m_size > 0) {
+        void *mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("failed to map file: " + filename);
+        }
+        m_data = static_cast<const char *>(mapping);
+    }
+
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+#if defined(_WIN32)
+        m_file    = std::exchange(other.m_file, nullptr);
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+#if defined(_WIN32)
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != nullptr) {
+        CloseHandle(m_file);
+    }
+    m_file    = nullptr;
+    m_mapping = nullptr;
+#else
+    if (m_data != nullptr) {
+        munmap(const_cast<char *>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
 std::string getExecutablePath() {
 #if defined(_WIN32)
     char result[MAX_PATH];
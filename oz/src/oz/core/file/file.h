@@ -1,14 +1,49 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace oz::file {
 
 std::vector<char> readFile(const std::string &filename);
+void writeFile(const std::string &filename, const void *data, size_t size);
+bool exists(const std::string &filename);
+
+// 64-bit content hash, not cryptographic, used to detect changed source files
+uint64_t hash(const void *data, size_t size, uint64_t seed = 0);
+uint64_t hashFile(const std::string &filename);
+
+// Read-only memory mapping of a whole file. Pages are loaded by the OS on first access,
+// so the mapped range can be copied to its destination without reading it into a buffer first.
+class MappedFile final {
+  public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string &filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)            = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    const char *data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool isOpen() const { return m_data != nullptr; }
+
+    void close();
+
+  private:
+    const char *m_data = nullptr;
+    size_t m_size      = 0;
+#if defined(_WIN32)
+    void *m_file    = nullptr;
+    void *m_mapping = nullptr;
+#endif
+};
 
 std::string getExecutablePath();
 std::string getBuildPath();
 std::string getSourcePath();
 
-} // namespace oz::file
+} // namespace oz::file
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "oz/core/job/job_system.h"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace oz::job {
+
+namespace {
+
+static constexpr uint32_t IDLE_SPINS = 64; // failed steal rounds before a worker sleeps
+
+// worker of the job system the current thread belongs to
+thread_local const JobSystem* t_jobSystem   = nullptr;
+thread_local int              t_workerIndex = -1;
+
+} // namespace
+
+// Work Stealing Deque
+
+void WorkStealingDeque::Slot::store(const Job& job) {
+    uint64_t jobWords[WORD_COUNT] = {};
+    std::memcpy(jobWords, &job, sizeof(Job));
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        words[i].store(jobWords[i], std::memory_order_relaxed);
+    }
+}
+
+Job WorkStealingDeque::Slot::load() const {
+    uint64_t jobWords[WORD_COUNT];
+    for (size_t i = 0; i < WORD_COUNT; i++) {
+        jobWords[i] = words[i].load(std::memory_order_relaxed);
+    }
+    Job job;
+    std::memcpy(&job, jobWords, sizeof(Job));
+    return job;
+}
+
+// the orderings of the fences in the original algorithm are carried by the operations themselves
+bool WorkStealingDeque::push(const Job& job) {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top    = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(CAPACITY)) {
+        return false;
+    }
+
+    m_jobs[bottom & MASK].store(job);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+bool WorkStealingDeque::pop(Job& job) {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_seq_cst);
+
+    if (top > bottom) {
+        // empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    job = m_jobs[bottom & MASK].load();
+    if (top == bottom) {
+        // last job, races with the thieves
+        const bool isTaken = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return isTaken;
+    }
+    return true;
+}
+
+bool WorkStealingDeque::steal(Job& job) {
+    int64_t top    = m_top.load(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_seq_cst);
+
+    if (top >= bottom) {
+        return false;
+    }
+
+    // copied before it is taken, once taken the owner may push over the slot
+    const Job stolen = m_jobs[top & MASK].load();
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return false; // lost to another thief or the owner
+    }
+    job = stolen;
+    return true;
+}
+
+bool WorkStealingDeque::empty() const {
+    return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+}
+
+// Job System
+
+struct JobSystem::Worker final {
+    WorkStealingDeque deque;
+
+    uint32_t randomState = 0; // picks the first victim to steal from
+};
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->randomState = 0x9e3779b9u * (i + 1);
+    }
+
+    // the constructing thread is the main thread
+    t_jobSystem   = this;
+    t_workerIndex = 0;
+
+    m_threads.reserve(workerCount - 1);
+    for (uint32_t i = 1; i < workerCount; i++) {
+        m_threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_isRunning = false;
+    }
+    m_sleepCondition.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+
+    if (t_jobSystem == this) {
+        t_jobSystem   = nullptr;
+        t_workerIndex = -1;
+    }
+}
+
+void JobSystem::run(const Job* jobs, uint32_t count, Counter& counter, Counter* dependency) {
+    if (!isWorkerThread()) {
+        throw std::runtime_error("Jobs can only be run from the main thread or from other jobs!");
+    }
+
+    counter.m_value.fetch_add(count, std::memory_order_acq_rel);
+
+    // the lock orders the registration against finish, either the continuations are taken or the counter is seen done
+    if (dependency != nullptr) {
+        std::lock_guard<std::mutex> lock(dependency->m_mutex);
+        if (dependency->getValue() != 0) {
+            for (uint32_t i = 0; i < count; i++) {
+                dependency->m_continuations.push_back(jobs[i]);
+                dependency->m_continuations.back().counter = &counter;
+            }
+            return;
+        }
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        Job job     = jobs[i];
+        job.counter = &counter;
+        push(job);
+    }
+}
+
+void JobSystem::runOnMainThread(const Job& job, Counter& counter) {
+    counter.m_value.fetch_add(1, std::memory_order_acq_rel);
+
+    std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+    m_mainThreadJobs.push_back(job);
+    m_mainThreadJobs.back().counter          = &counter;
+    m_mainThreadJobs.back().isMainThreadOnly = true;
+}
+
+void JobSystem::wait(Counter& counter) {
+    const int workerIndex = getWorkerIndex();
+
+    while (!counter.isDone()) {
+        if (workerIndex == 0) {
+            processMainThreadJobs();
+        }
+        if (workerIndex < 0 || !executeNext(static_cast<uint32_t>(workerIndex))) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::processMainThreadJobs() {
+    assert(isMainThread());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        if (m_mainThreadJobs.empty()) {
+            return;
+        }
+        m_mainThreadScratch.swap(m_mainThreadJobs);
+    }
+
+    for (const Job& job : m_mainThreadScratch) {
+        execute(job);
+    }
+    m_mainThreadScratch.clear();
+}
+
+bool JobSystem::isWorkerThread() const { return t_jobSystem == this && t_workerIndex >= 0; }
+
+bool JobSystem::isMainThread() const { return t_jobSystem == this && t_workerIndex == 0; }
+
+int JobSystem::getWorkerIndex() const { return t_jobSystem == this ? t_workerIndex : -1; }
+
+void JobSystem::push(const Job& job) {
+    if (job.isMainThreadOnly) {
+        std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+        m_mainThreadJobs.push_back(job);
+        return;
+    }
+
+    Worker& worker = *m_workers[t_workerIndex];
+
+    // counted before the push, a thief can take the job right after it
+    m_queuedCount.fetch_add(1, std::memory_order_seq_cst);
+    if (!worker.deque.push(job)) {
+        // a full deque runs the job right away, which is still correct as long as the caller waits on its counter
+        m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+        execute(job);
+        return;
+    }
+
+    if (m_sleepingCount.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_one();
+    }
+}
+
+bool JobSystem::executeNext(uint32_t workerIndex) {
+    Worker& worker = *m_workers[workerIndex];
+
+    Job  job;
+    bool isTaken = worker.deque.pop(job);
+    if (!isTaken) {
+        // steal from the others, starting at a random victim so thieves spread out
+        const uint32_t workerCount = getWorkerCount();
+        worker.randomState ^= worker.randomState << 13;
+        worker.randomState ^= worker.randomState >> 17;
+        worker.randomState ^= worker.randomState << 5;
+
+        uint32_t victim = worker.randomState % workerCount;
+        for (uint32_t i = 0; i < workerCount && !isTaken; i++, victim = (victim + 1) % workerCount) {
+            if (victim != workerIndex) {
+                isTaken = m_workers[victim]->deque.steal(job);
+            }
+        }
+    }
+    if (!isTaken) {
+        return false;
+    }
+
+    m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+    execute(job);
+    return true;
+}
+
+void JobSystem::execute(Job job) {
+    job.function(job.data, job.begin, job.end);
+    finish(job.counter);
+}
+
+void JobSystem::finish(Counter* counter) {
+    if (counter == nullptr) {
+        return;
+    }
+
+    counter->m_finishingCount.fetch_add(1, std::memory_order_seq_cst);
+    if (counter->m_value.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+        // the last job of the batch starts the jobs depending on it
+        std::vector<Job> continuations;
+        {
+            std::lock_guard<std::mutex> lock(counter->m_mutex);
+            continuations.swap(counter->m_continuations);
+        }
+
+        for (const Job& job : continuations) {
+            push(job);
+        }
+    }
+    counter->m_finishingCount.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void JobSystem::workerLoop(uint32_t workerIndex) {
+    t_jobSystem   = this;
+    t_workerIndex = static_cast<int>(workerIndex);
+
+    uint32_t idleSpins = 0;
+    while (m_isRunning.load(std::memory_order_relaxed)) {
+        if (executeNext(workerIndex)) {
+            idleSpins = 0;
+            continue;
+        }
+        if (++idleSpins < IDLE_SPINS) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // sleep until jobs are pushed, the timeout covers jobs that became runnable without a push notification
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+        m_sleepCondition.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+            return m_queuedCount.load(std::memory_order_seq_cst) > 0 || !m_isRunning.load(std::memory_order_relaxed);
+        });
+        m_sleepingCount.fetch_sub(1, std::memory_order_seq_cst);
+        idleSpins = 0;
+    }
+}
+
+JobSystem& getJobSystem() {
+    static JobSystem jobSystem;
+    return jobSystem;
+}
+
+} // namespace oz::job
\ No newline at end of file
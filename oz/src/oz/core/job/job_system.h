@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace oz::job {
+
+class Counter;
+
+// A function with its data and a range, small and trivially copyable so it can be stored by value.
+// The data has to outlive the job, parallelFor keeps it on the stack of the waiting caller.
+struct Job final {
+    using Function = void (*)(void* data, uint32_t begin, uint32_t end);
+
+    Function function = nullptr;
+    void*    data     = nullptr;
+    uint32_t begin    = 0;
+    uint32_t end      = 0;
+
+    Counter* counter          = nullptr; // decremented once the job has finished, set by JobSystem::run
+    bool     isMainThreadOnly = false;   // set by JobSystem::runOnMainThread
+};
+
+// Number of unfinished jobs of a batch. Jobs can wait on a counter through JobSystem::run, they are started once it
+// reaches zero. A counter has to outlive its jobs and the jobs depending on it.
+class Counter final {
+  public:
+    Counter() = default;
+
+    Counter(const Counter&)            = delete;
+    Counter& operator=(const Counter&) = delete;
+
+    uint32_t getValue() const { return m_value.load(std::memory_order_seq_cst); }
+    // also waits for the last job to stop touching the counter, so it can be destroyed right after
+    bool     isDone() const { return getValue() == 0 && m_finishingCount.load(std::memory_order_seq_cst) == 0; }
+
+  private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_value          = 0;
+    std::atomic<uint32_t> m_finishingCount = 0; // jobs between their decrement and their last access of the counter
+    std::mutex            m_mutex;              // guards the continuations, only locked at registration and completion
+    std::vector<Job>      m_continuations;      // jobs waiting for the counter to reach zero
+};
+
+// Fixed capacity Chase-Lev deque. The owning worker pushes and pops at the bottom, other workers steal from the top,
+// none of them take a lock. Jobs are stored by value and copied out before they are taken, so a taken job does not
+// depend on storage the owner can reuse.
+class WorkStealingDeque final {
+  public:
+    static constexpr uint32_t CAPACITY = 4096;
+
+    bool push(const Job& job); // owner only, false when full
+    bool pop(Job& job);        // owner only
+    bool steal(Job& job);
+
+    bool empty() const;
+
+  private:
+    static constexpr uint32_t MASK = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0, "Deque capacity has to be a power of two!");
+    static_assert(std::is_trivially_copyable_v<Job>, "Jobs are copied word by word!");
+
+    // a thief may read a slot while the owner writes it, the read is only kept if taking the job succeeds afterwards
+    // and the owner cannot write the slot of an untaken job, atomic words keep the discarded torn reads well defined
+    struct Slot {
+        static constexpr size_t WORD_COUNT = (sizeof(Job) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        std::atomic<uint64_t> words[WORD_COUNT];
+
+        void store(const Job& job);
+        Job  load() const;
+    };
+
+    alignas(64) std::atomic<int64_t> m_top    = 0;
+    alignas(64) std::atomic<int64_t> m_bottom = 0;
+    Slot m_jobs[CAPACITY];
+};
+
+// Work-stealing scheduler. The thread constructing it is the main thread and worker 0, the others run on their own
+// threads. Waiting on a counter runs queued jobs instead of blocking, on the main thread also the main-thread jobs.
+// Jobs can be submitted from the main thread and from other jobs.
+class JobSystem final {
+  public:
+    static constexpr uint32_t RANGES_PER_WORKER = 4; // default split of parallelFor, spare ranges balance the load
+
+    explicit JobSystem(uint32_t workerCount = 0); // 0 picks the hardware concurrency, the main thread included
+    ~JobSystem();
+
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // starts the jobs once dependency reaches zero, counter is increased by the job count right away
+    void run(const Job* jobs, uint32_t count, Counter& counter, Counter* dependency = nullptr);
+    void run(const Job& job, Counter& counter, Counter* dependency = nullptr) { run(&job, 1, counter, dependency); }
+    // for calls that are only allowed on the main thread, like most of GLFW, runs when the main thread waits
+    void runOnMainThread(const Job& job, Counter& counter);
+
+    // runs jobs until the counter reaches zero
+    void wait(Counter& counter);
+    // runs the queued main-thread jobs, to be called periodically by a main thread that does not wait
+    void processMainThreadJobs();
+
+    // Runs fn(begin, end) over [0, count) in up to maxRangeCount ranges of at least minRangeSize items and waits for
+    // them, the caller takes part. maxRangeCount 0 picks RANGES_PER_WORKER ranges per worker. The first exception
+    // thrown by fn is rethrown after every range finished. Runs inline on threads that do not belong to the system.
+    template <typename F>
+    void parallelFor(uint32_t count, uint32_t minRangeSize, uint32_t maxRangeCount, F&& fn);
+
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    bool     isWorkerThread() const;
+    bool     isMainThread() const;
+
+  private:
+    struct Worker;
+
+    void push(const Job& job);
+    bool executeNext(uint32_t workerIndex);
+    void execute(Job job);
+    void finish(Counter* counter);
+    void workerLoop(uint32_t workerIndex);
+    int  getWorkerIndex() const;
+
+  private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread>             m_threads;
+    std::atomic<bool>                    m_isRunning = true;
+
+    // sleeping workers are woken when jobs are pushed
+    std::mutex              m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<uint32_t>   m_sleepingCount = 0;
+    std::atomic<uint32_t>   m_queuedCount   = 0;
+
+    std::mutex       m_mainThreadMutex;
+    std::vector<Job> m_mainThreadJobs;
+    std::vector<Job> m_mainThreadScratch;
+};
+
+// Process wide job system, created on first use with one worker per hardware thread.
+// The first call has to come from the main thread.
+JobSystem& getJobSystem();
+
+template <typename F>
+void JobSystem::parallelFor(uint32_t count, uint32_t minRangeSize, uint32_t maxRangeCount, F&& fn) {
+    if (count == 0) {
+        return;
+    }
+    if (maxRangeCount == 0) {
+        maxRangeCount = getWorkerCount() * RANGES_PER_WORKER;
+    }
+    const uint32_t rangeCount = std::clamp((count + minRangeSize - 1) / std::max(minRangeSize, 1u), 1u, maxRangeCount);
+
+    if (rangeCount == 1 || !isWorkerThread()) {
+        fn(0u, count);
+        return;
+    }
+
+    using Function = std::remove_reference_t<F>;
+    struct Context {
+        Function*          fn;
+        std::atomic<bool>  hasException = false;
+        std::exception_ptr exception;
+    } context{&fn};
+
+    Job job;
+    job.data     = &context;
+    job.function = [](void* data, uint32_t begin, uint32_t end) {
+        Context& context = *static_cast<Context*>(data);
+        try {
+            (*context.fn)(begin, end);
+        } catch (...) {
+            if (!context.hasException.exchange(true)) {
+                context.exception = std::current_exception();
+            }
+        }
+    };
+
+    Counter counter;
+    for (uint32_t range = 0; range < rangeCount; range++) {
+        job.begin = static_cast<uint32_t>(uint64_t(count) * range / rangeCount);
+        job.end   = static_cast<uint32_t>(uint64_t(count) * (range + 1) / rangeCount);
+        run(job, counter);
+    }
+    wait(counter);
+
+    if (context.exception) {
+        std::rethrow_exception(context.exception);
+    }
+}
+
+} // namespace oz::job
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace oz::memory {
+
+// 32-bit generational handle: the low bits index a pool slot, the high bits hold the slot generation at creation time.
+// A zero value is the null handle since generations start at 1.
+template <typename T>
+struct Handle final {
+    static constexpr uint32_t INDEX_BITS      = 20;
+    static constexpr uint32_t GENERATION_BITS = 32 - INDEX_BITS;
+    static constexpr uint32_t INDEX_MASK      = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+    uint32_t value = 0;
+
+    Handle() = default;
+    Handle(uint32_t index, uint32_t generation) : value((generation << INDEX_BITS) | (index & INDEX_MASK)) {}
+
+    uint32_t index() const { return value & INDEX_MASK; }
+    uint32_t generation() const { return value >> INDEX_BITS; }
+
+    explicit operator bool() const { return value != 0; }
+    bool     operator==(const Handle& other) const = default;
+};
+
+// Fixed capacity slot map. Objects live in one contiguous array allocated up front, so create/destroy never touch the heap.
+// Stale handles are caught by the generation check in debug builds.
+template <typename T>
+class HandlePool final {
+  public:
+    explicit HandlePool(uint32_t capacity) : m_objects(capacity), m_generations(capacity, 1) {
+        assert(capacity > 0 && capacity <= Handle<T>::INDEX_MASK + 1);
+
+        m_freeList.reserve(capacity);
+        for (uint32_t i = capacity; i > 0; i--) {
+            m_freeList.push_back(i - 1);
+        }
+    }
+
+    HandlePool(const HandlePool&)            = delete;
+    HandlePool& operator=(const HandlePool&) = delete;
+
+    Handle<T> create() {
+        if (m_freeList.empty()) {
+            throw std::runtime_error("Handle pool is exhausted!");
+        }
+
+        uint32_t index = m_freeList.back();
+        m_freeList.pop_back();
+
+        return Handle<T>(index, m_generations[index]);
+    }
+
+    void destroy(Handle<T> handle) {
+        assert(isValid(handle));
+
+        uint32_t index   = handle.index();
+        m_objects[index] = T{};
+
+        // bump the generation so that outstanding handles to this slot become stale, 0 is reserved for the null handle
+        uint32_t generation  = (m_generations[index] + 1) & Handle<T>::GENERATION_MASK;
+        m_generations[index] = generation == 0 ? 1 : generation;
+
+        m_freeList.push_back(index);
+    }
+
+    bool isValid(Handle<T> handle) const {
+        return handle && handle.index() < m_objects.size() && m_generations[handle.index()] == handle.generation();
+    }
+
+    T& get(Handle<T> handle) {
+        assert(isValid(handle));
+        return m_objects[handle.index()];
+    }
+
+    const T& get(Handle<T> handle) const {
+        assert(isValid(handle));
+        return m_objects[handle.index()];
+    }
+
+    uint32_t size() const { return capacity() - static_cast<uint32_t>(m_freeList.size()); }
+    uint32_t capacity() const { return static_cast<uint32_t>(m_objects.size()); }
+
+  private:
+    std::vector<T>        m_objects;
+    std::vector<uint16_t> m_generations;
+    std::vector<uint32_t> m_freeList;
+};
+
+} // namespace oz::memory
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+namespace oz::memory {
+
+// Fixed capacity array with a size, the elements are stored inline so building and copying it never touches the heap.
+// Limited to trivially copyable types, which do not need a default constructor, and copies are plain byte copies.
+// Adding beyond the capacity throws, so it is meant for creation paths and not for per-frame containers.
+template <typename T, uint32_t N>
+class InlineVector final {
+    static_assert(std::is_trivially_copyable_v<T>, "InlineVector elements have to be trivially copyable!");
+
+  public:
+    InlineVector() = default;
+    InlineVector(std::initializer_list<T> values) { assign(values.begin(), values.size()); }
+    InlineVector(std::span<const T> values) { assign(values.data(), values.size()); }
+
+    void push_back(const T& value) {
+        if (m_size == N) {
+            throw std::runtime_error("Inline vector capacity is exceeded!");
+        }
+        std::memcpy(&m_storage[m_size * sizeof(T)], &value, sizeof(T));
+        m_size++;
+    }
+    void clear() { m_size = 0; }
+
+    T*       data() { return reinterpret_cast<T*>(m_storage); }
+    const T* data() const { return reinterpret_cast<const T*>(m_storage); }
+    T*       begin() { return data(); }
+    T*       end() { return data() + m_size; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + m_size; }
+
+    T&       operator[](size_t index) { return data()[index]; }
+    const T& operator[](size_t index) const { return data()[index]; }
+
+    size_t                    size() const { return m_size; }
+    bool                      empty() const { return m_size == 0; }
+    static constexpr uint32_t capacity() { return N; }
+
+    operator std::span<const T>() const { return {data(), m_size}; }
+
+  private:
+    void assign(const T* values, size_t count) {
+        if (count > N) {
+            throw std::runtime_error("Inline vector capacity is exceeded!");
+        }
+        std::memcpy(m_storage, values, count * sizeof(T));
+        m_size = static_cast<uint32_t>(count);
+    }
+
+  private:
+    alignas(T) std::byte m_storage[N * sizeof(T)];
+    uint32_t             m_size = 0;
+};
+
+} // namespace oz::memory
\ No newline at end of file
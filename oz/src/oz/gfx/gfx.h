@@ -1,6 +1,9 @@
 #pragma once
 
+#include "oz/gfx/vulkan/capture.h"
 #include "oz/gfx/vulkan/enums.h"
 #include "oz/gfx/vulkan/graphics_device.h"
 #include "oz/gfx/vulkan/objects.h"
-#include "oz/gfx/vulkan/property_structs.h"
\ No newline at end of file
+#include "oz/gfx/vulkan/property_structs.h"
+#include "oz/gfx/vulkan/render_queue.h"
+#include "oz/gfx/vulkan/stats.h"
\ No newline at end of file
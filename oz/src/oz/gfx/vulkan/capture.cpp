@@ -0,0 +1,543 @@
+#include "oz/gfx/vulkan/capture.h"
+#include "oz/core/file/file.h"
+#include "oz/gfx/vulkan/graphics_device.h"
+
+namespace oz::gfx::vk {
+
+namespace {
+static constexpr size_t HEADER_SIZE        = 3 * sizeof(uint32_t); // magic, version, frame count
+static constexpr size_t FRAME_COUNT_OFFSET = 2 * sizeof(uint32_t);
+} // namespace
+
+// Capture Writer
+
+CaptureWriter::CaptureWriter(const std::string& path, uint32_t frameCount) : m_frameCount(frameCount) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        throw std::runtime_error("Failed to open capture file!");
+    }
+
+    const uint32_t header[] = {MAGIC, VERSION, frameCount};
+    m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    m_isRecording = frameCount > 0;
+}
+
+CaptureWriter::~CaptureWriter() {
+    // an interrupted capture keeps the frames recorded so far
+    if (m_isRecording) {
+        finish();
+    }
+}
+
+void CaptureWriter::endFrame() {
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_buffer.clear();
+
+    m_frameIndex++;
+    if (m_frameIndex == m_frameCount) {
+        finish();
+    }
+}
+
+void CaptureWriter::finish() {
+    // records of an unfinished frame are dropped, the replay ends with the last presented frame
+    m_buffer.clear();
+    m_file.seekp(FRAME_COUNT_OFFSET);
+    m_file.write(reinterpret_cast<const char*>(&m_frameIndex), sizeof(uint32_t));
+    m_file.close();
+
+    m_isRecording = false;
+    std::cout << "Captured " << m_frameIndex << " frame(s)\n";
+}
+
+void CaptureWriter::write(const std::string& value) {
+    write(static_cast<uint32_t>(value.size()));
+    writeBytes(value.data(), value.size());
+}
+
+void CaptureWriter::write(const CaptureBlob& blob) {
+    write(blob.size);
+    writeBytes(blob.data, blob.size);
+}
+
+void CaptureWriter::write(const VertexLayoutInfo& vertexLayout) {
+    write(vertexLayout.vertexSize);
+    write(static_cast<uint32_t>(vertexLayout.vertexLayoutAttributes.size()));
+    for (const VertexLayoutAttributeInfo& attribute : vertexLayout.vertexLayoutAttributes) {
+        write(static_cast<uint64_t>(attribute.offset));
+        write(attribute.format);
+    }
+}
+
+void CaptureWriter::write(const DescriptorSetLayoutInfo& setLayout) {
+    write(static_cast<uint32_t>(setLayout.bindings.size()));
+    for (const DescriptorSetLayoutBindingInfo& binding : setLayout.bindings) {
+        write(binding.type);
+    }
+}
+
+void CaptureWriter::write(const DescriptorSetInfo& setInfo) {
+    write(static_cast<uint32_t>(setInfo.bindings.size()));
+    for (const DescriptorSetBindingInfo& binding : setInfo.bindings) {
+        write(binding.bufferInfo.buffer);
+        write(static_cast<uint64_t>(binding.bufferInfo.range));
+    }
+}
+
+void CaptureWriter::write(const SpecializationConstants& specialization) {
+    write(specialization.entries);
+    write(specialization.data);
+}
+
+void CaptureWriter::writeBytes(const void* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+}
+
+// Capture Reader
+
+CaptureReader::CaptureReader(const std::string& path) : m_data(file::readFile(path)) {
+    uint32_t header[3] = {};
+    if (m_data.size() >= HEADER_SIZE) {
+        std::memcpy(header, m_data.data(), HEADER_SIZE);
+    }
+    if (header[0] != CaptureWriter::MAGIC) {
+        throw std::runtime_error("Not a capture file!");
+    }
+    if (header[1] != CaptureWriter::VERSION) {
+        throw std::runtime_error("Unsupported capture file version!");
+    }
+
+    m_frameCount = header[2];
+    m_offset     = HEADER_SIZE;
+    m_recordEnd  = HEADER_SIZE;
+}
+
+bool CaptureReader::next(CaptureCommand& command) {
+    m_offset    = m_recordEnd;
+    m_recordEnd = m_data.size();
+    if (m_offset + sizeof(uint16_t) + sizeof(uint32_t) > m_data.size()) {
+        return false;
+    }
+
+    command                    = static_cast<CaptureCommand>(read<uint16_t>());
+    const uint32_t payloadSize = read<uint32_t>();
+    m_recordEnd                = m_offset + payloadSize;
+    if (m_recordEnd > m_data.size()) {
+        throw std::runtime_error("Capture file is truncated!");
+    }
+
+    return command != CaptureCommand::End;
+}
+
+void CaptureReader::skip() { m_offset = m_recordEnd; }
+
+std::string CaptureReader::readString() {
+    std::string value(read<uint32_t>(), '\0');
+    readBytes(value.data(), value.size());
+    return value;
+}
+
+CaptureBlob CaptureReader::readBlob() {
+    CaptureBlob blob;
+    blob.size = read<uint64_t>();
+    if (m_offset + blob.size > m_recordEnd) {
+        throw std::runtime_error("Capture record is truncated!");
+    }
+    blob.data = m_data.data() + m_offset;
+    m_offset += blob.size;
+    return blob;
+}
+
+VertexLayoutInfo CaptureReader::readVertexLayout() {
+    const uint32_t vertexSize = read<uint32_t>();
+
+    std::vector<VertexLayoutAttributeInfo> attributes;
+    const uint32_t                         attributeCount = read<uint32_t>();
+    for (uint32_t i = 0; i < attributeCount; i++) {
+        const uint64_t offset = read<uint64_t>();
+        attributes.emplace_back(static_cast<size_t>(offset), read<Format>());
+    }
+
+    return VertexLayoutInfo(vertexSize, std::span<const VertexLayoutAttributeInfo>(attributes));
+}
+
+DescriptorSetLayoutInfo CaptureReader::readDescriptorSetLayout() {
+    std::vector<DescriptorSetLayoutBindingInfo> bindings;
+    const uint32_t                              bindingCount = read<uint32_t>();
+    for (uint32_t i = 0; i < bindingCount; i++) {
+        bindings.emplace_back(read<BindingType>());
+    }
+
+    return DescriptorSetLayoutInfo(std::span<const DescriptorSetLayoutBindingInfo>(bindings));
+}
+
+DescriptorSetInfo CaptureReader::readDescriptorSet() {
+    std::vector<DescriptorSetBindingInfo> bindings;
+    const uint32_t                        bindingCount = read<uint32_t>();
+    for (uint32_t i = 0; i < bindingCount; i++) {
+        const Buffer   buffer = read<Buffer>();
+        const uint64_t range  = read<uint64_t>();
+        bindings.emplace_back(DescriptorSetBufferInfo(buffer, static_cast<size_t>(range)));
+    }
+
+    return DescriptorSetInfo(std::span<const DescriptorSetBindingInfo>(bindings));
+}
+
+SpecializationConstants CaptureReader::readSpecialization() {
+    SpecializationConstants specialization;
+    specialization.entries = readVector<SpecializationConstants::Entry>();
+    specialization.data    = readVector<uint8_t>();
+    return specialization;
+}
+
+void CaptureReader::readBytes(void* data, size_t size) {
+    if (m_offset + size > m_recordEnd) {
+        throw std::runtime_error("Capture record is truncated!");
+    }
+    std::memcpy(data, m_data.data() + m_offset, size);
+    m_offset += size;
+}
+
+// Capture Replayer
+
+CaptureReplayer::CaptureReplayer(GraphicsDevice& device, const std::string& path) : m_device(device), m_reader(path) {}
+
+template <typename T>
+memory::Handle<T> CaptureReplayer::map(memory::Handle<T> captured) const {
+    if (!captured) {
+        return {};
+    }
+
+    const HandleMap<T>& handles = std::get<HandleMap<T>>(m_handles);
+    auto                it      = handles.find(captured.value);
+    if (it == handles.end()) {
+        throw std::runtime_error("Capture references an unknown object!");
+    }
+    return it->second;
+}
+
+template <typename T>
+void CaptureReplayer::bind(memory::Handle<T> captured, memory::Handle<T> replayed) {
+    if (captured) {
+        std::get<HandleMap<T>>(m_handles)[captured.value] = replayed;
+    }
+}
+
+template <typename T>
+void CaptureReplayer::free(memory::Handle<T> captured) {
+    m_device.free(map(captured));
+    std::get<HandleMap<T>>(m_handles).erase(captured.value);
+}
+
+bool CaptureReplayer::replayFrame() {
+    CaptureCommand command;
+    while (m_reader.next(command)) {
+        if (!replay(command)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CaptureReplayer::replay(CaptureCommand command) {
+    switch (command) {
+    // create methods
+    case CaptureCommand::CreateWindow: {
+        const uint32_t    width  = m_reader.read<uint32_t>();
+        const uint32_t    height = m_reader.read<uint32_t>();
+        const std::string name   = m_reader.readString();
+        bind(m_reader.read<Window>(), m_device.createWindow(width, height, name.c_str()));
+        break;
+    }
+    case CaptureCommand::CreateCommandBuffer: {
+        const QueueType queueType = m_reader.read<QueueType>();
+        bind(m_reader.read<CommandBuffer>(), m_device.createCommandBuffer(queueType));
+        break;
+    }
+    case CaptureCommand::CreateCommandBundle: bind(m_reader.read<CommandBuffer>(), m_device.createCommandBundle()); break;
+    case CaptureCommand::CreateShader: {
+        const CaptureBlob             code           = m_reader.readBlob();
+        const ShaderStage             stage          = m_reader.read<ShaderStage>();
+        const SpecializationConstants specialization = m_reader.readSpecialization();
+        const char*                   codeBytes      = static_cast<const char*>(code.data);
+        bind(m_reader.read<Shader>(), m_device.createShader(std::vector<char>(codeBytes, codeBytes + code.size), stage, specialization));
+        break;
+    }
+    case CaptureCommand::CreateRenderPass:
+    case CaptureCommand::CreateDynamicRenderPass: {
+        const Shader                     vertexShader         = map(m_reader.read<Shader>());
+        const Shader                     fragmentShader       = map(m_reader.read<Shader>());
+        const Window                     window               = m_reader.read<Window>();
+        const VertexLayoutInfo           vertexLayout         = m_reader.readVertexLayout();
+        std::vector<DescriptorSetLayout> descriptorSetLayouts = m_reader.readVector<DescriptorSetLayout>();
+        const SpecializationConstants    specialization       = m_reader.readSpecialization();
+        const RenderPass                 renderPass           = m_reader.read<RenderPass>();
+        for (DescriptorSetLayout& layout : descriptorSetLayouts) {
+            layout = map(layout);
+        }
+
+        RenderPass replayed;
+        if (command == CaptureCommand::CreateRenderPass) {
+            replayed = m_device.createRenderPass(vertexShader, fragmentShader, map(window), vertexLayout, descriptorSetLayouts, specialization);
+        } else {
+            replayed =
+                m_device.createDynamicRenderPass(vertexShader, fragmentShader, map(window), vertexLayout, descriptorSetLayouts, specialization);
+        }
+        bind(renderPass, replayed);
+        m_renderPassWindows[renderPass.value] = window;
+        break;
+    }
+    case CaptureCommand::CreateSemaphore: bind(m_reader.read<Semaphore>(), m_device.createSemaphore()); break;
+    case CaptureCommand::CreateTimeline: {
+        const uint64_t initialValue = m_reader.read<uint64_t>();
+        bind(m_reader.read<Timeline>(), m_device.createTimeline(initialValue));
+        break;
+    }
+    case CaptureCommand::CreateFence: bind(m_reader.read<Fence>(), m_device.createFence()); break;
+    case CaptureCommand::CreateBuffer: {
+        const BufferType  bufferType = m_reader.read<BufferType>();
+        const uint64_t    size       = m_reader.read<uint64_t>();
+        const CaptureBlob data       = m_reader.readBlob();
+        bind(m_reader.read<Buffer>(), m_device.createBuffer(bufferType, size, data.size > 0 ? data.data : nullptr));
+        break;
+    }
+    case CaptureCommand::CreateDescriptorSetLayout: {
+        const DescriptorSetLayoutInfo setLayout = m_reader.readDescriptorSetLayout();
+        bind(m_reader.read<DescriptorSetLayout>(), m_device.createDescriptorSetLayout(setLayout));
+        break;
+    }
+    case CaptureCommand::CreateDescriptorSet: {
+        const DescriptorSetLayout setLayout = map(m_reader.read<DescriptorSetLayout>());
+        DescriptorSetInfo         setInfo   = m_reader.readDescriptorSet();
+        for (DescriptorSetBindingInfo& binding : setInfo.bindings) {
+            binding.bufferInfo.buffer = map(binding.bufferInfo.buffer);
+        }
+        bind(m_reader.read<DescriptorSet>(), m_device.createDescriptorSet(setLayout, setInfo));
+        break;
+    }
+
+    // sync methods
+    case CaptureCommand::WaitIdle: m_device.waitIdle(); break;
+    case CaptureCommand::WaitFences: {
+        const Fence    fence      = map(m_reader.read<Fence>());
+        const uint32_t fenceCount = m_reader.read<uint32_t>();
+        m_device.waitFences(fence, fenceCount, m_reader.read<bool>());
+        break;
+    }
+    case CaptureCommand::ResetFences: {
+        const Fence fence = map(m_reader.read<Fence>());
+        m_device.resetFences(fence, m_reader.read<uint32_t>());
+        break;
+    }
+    case CaptureCommand::WaitTimeline:
+    case CaptureCommand::SignalTimeline: {
+        const Timeline      timeline = m_reader.read<Timeline>();
+        const TimelinePoint point    = mapPoint(TimelinePoint(timeline, m_reader.read<uint64_t>()));
+        if (command == CaptureCommand::WaitTimeline) {
+            m_device.waitTimeline(point.timeline, point.value);
+        } else {
+            m_device.signalTimeline(point.timeline, point.value);
+        }
+        break;
+    }
+
+    // state getters
+    case CaptureCommand::GetUniformRing: bind(m_reader.read<Buffer>(), m_device.getUniformRing()); break;
+    case CaptureCommand::GetCurrentCommandBuffer: bind(m_reader.read<CommandBuffer>(), m_device.getCurrentCommandBuffer()); break;
+    case CaptureCommand::GetCurrentImage: {
+        const Window   window     = m_reader.read<Window>();
+        const uint32_t imageIndex = m_reader.read<uint32_t>();
+        m_imageIndices[(uint64_t(window.value) << 32) | imageIndex] = m_device.getCurrentImage(map(window));
+        break;
+    }
+
+    // frame methods
+    case CaptureCommand::BeginFrame: m_device.beginFrame(); break;
+    case CaptureCommand::PresentFrame: m_device.presentFrame(); return false;
+    case CaptureCommand::PollEvents: m_device.pollEvents(); break;
+
+    // command methods
+    case CaptureCommand::BeginCmd: {
+        const CommandBuffer cmd = map(m_reader.read<CommandBuffer>());
+        m_device.beginCmd(cmd, m_reader.read<bool>());
+        break;
+    }
+    case CaptureCommand::EndCmd: m_device.endCmd(map(m_reader.read<CommandBuffer>())); break;
+    case CaptureCommand::SubmitCmd: {
+        const CommandBuffer        cmd     = map(m_reader.read<CommandBuffer>());
+        std::vector<TimelinePoint> waits   = m_reader.readVector<TimelinePoint>();
+        std::vector<TimelinePoint> signals = m_reader.readVector<TimelinePoint>();
+        for (TimelinePoint& wait : waits) {
+            wait = mapPoint(wait);
+        }
+        for (TimelinePoint& signal : signals) {
+            signal = mapPoint(signal);
+        }
+        bindPoint(m_reader.read<TimelinePoint>(), m_device.submitCmd(cmd, waits, signals));
+        break;
+    }
+    case CaptureCommand::BeginRenderPass: {
+        const CommandBuffer      cmd        = map(m_reader.read<CommandBuffer>());
+        const RenderPass         renderPass = m_reader.read<RenderPass>();
+        const uint32_t           imageIndex = m_reader.read<uint32_t>();
+        const RenderPassContents contents   = m_reader.read<RenderPassContents>();
+        m_device.beginRenderPass(cmd, map(renderPass), mapImageIndex(m_renderPassWindows[renderPass.value], imageIndex), contents);
+        break;
+    }
+    case CaptureCommand::EndRenderPass: m_device.endRenderPass(map(m_reader.read<CommandBuffer>())); break;
+    case CaptureCommand::BeginRendering: {
+        const CommandBuffer              cmd              = map(m_reader.read<CommandBuffer>());
+        std::vector<RenderingAttachment> colorAttachments = m_reader.readVector<RenderingAttachment>();
+        for (RenderingAttachment& attachment : colorAttachments) {
+            attachment.imageIndex = mapImageIndex(attachment.window, attachment.imageIndex);
+            attachment.window     = map(attachment.window);
+        }
+        m_device.beginRendering(cmd, colorAttachments, m_reader.read<RenderPassContents>());
+        break;
+    }
+    case CaptureCommand::EndRendering: m_device.endRendering(map(m_reader.read<CommandBuffer>())); break;
+    case CaptureCommand::Draw: {
+        const CommandBuffer cmd  = map(m_reader.read<CommandBuffer>());
+        const auto          args = m_reader.read<std::array<uint32_t, 4>>();
+        m_device.draw(cmd, args[0], args[1], args[2], args[3]);
+        break;
+    }
+    case CaptureCommand::DrawIndexed: {
+        const CommandBuffer cmd  = map(m_reader.read<CommandBuffer>());
+        const auto          args = m_reader.read<std::array<uint32_t, 5>>();
+        m_device.drawIndexed(cmd, args[0], args[1], args[2], args[3], args[4]);
+        break;
+    }
+    case CaptureCommand::BindPipeline: {
+        const CommandBuffer cmd = map(m_reader.read<CommandBuffer>());
+        m_device.bindPipeline(cmd, map(m_reader.read<RenderPass>()));
+        break;
+    }
+    case CaptureCommand::BindVertexBuffer: {
+        const CommandBuffer cmd = map(m_reader.read<CommandBuffer>());
+        m_device.bindVertexBuffer(cmd, map(m_reader.read<Buffer>()));
+        break;
+    }
+    case CaptureCommand::BindIndexBuffer: {
+        const CommandBuffer cmd         = map(m_reader.read<CommandBuffer>());
+        const Buffer        indexBuffer = map(m_reader.read<Buffer>());
+        m_device.bindIndexBuffer(cmd, indexBuffer, m_reader.read<IndexType>());
+        break;
+    }
+    case CaptureCommand::BindDescriptorSet: {
+        const CommandBuffer         cmd            = map(m_reader.read<CommandBuffer>());
+        const RenderPass            renderPass     = map(m_reader.read<RenderPass>());
+        const DescriptorSet         descriptorSet  = map(m_reader.read<DescriptorSet>());
+        const uint32_t              setIndex       = m_reader.read<uint32_t>();
+        const std::vector<uint32_t> dynamicOffsets = m_reader.readVector<uint32_t>();
+        m_device.bindDescriptorSet(cmd, renderPass, descriptorSet, setIndex, dynamicOffsets);
+        break;
+    }
+
+    // bundle methods
+    case CaptureCommand::BeginBundle: {
+        const CommandBuffer bundle        = map(m_reader.read<CommandBuffer>());
+        const RenderPass    renderPass    = map(m_reader.read<RenderPass>());
+        const uint64_t      inputsVersion = m_reader.read<uint64_t>();
+        if (m_device.beginBundle(bundle, renderPass, inputsVersion) != m_reader.read<bool>()) {
+            throw std::runtime_error("Replayed bundle state differs from the capture!");
+        }
+        break;
+    }
+    case CaptureCommand::InvalidateBundle: m_device.invalidateBundle(map(m_reader.read<CommandBuffer>())); break;
+    case CaptureCommand::ExecuteBundles: {
+        const CommandBuffer        cmd     = map(m_reader.read<CommandBuffer>());
+        std::vector<CommandBuffer> bundles = m_reader.readVector<CommandBuffer>();
+        for (CommandBuffer& bundle : bundles) {
+            bundle = map(bundle);
+        }
+        m_device.executeBundles(cmd, bundles);
+        break;
+    }
+
+    // buffer methods
+    case CaptureCommand::UpdateBuffer: {
+        const Buffer      buffer = map(m_reader.read<Buffer>());
+        const CaptureBlob data   = m_reader.readBlob();
+        m_device.updateBuffer(buffer, data.data, data.size);
+        break;
+    }
+    case CaptureCommand::CopyBuffer: {
+        const Buffer   src  = map(m_reader.read<Buffer>());
+        const Buffer   dst  = map(m_reader.read<Buffer>());
+        const uint64_t size = m_reader.read<uint64_t>();
+        bindPoint(m_reader.read<TimelinePoint>(), m_device.copyBuffer(src, dst, size));
+        break;
+    }
+    case CaptureCommand::UploadBuffer: {
+        const Buffer      dst       = map(m_reader.read<Buffer>());
+        const uint64_t    dstOffset = m_reader.read<uint64_t>();
+        const CaptureBlob data      = m_reader.readBlob();
+        bindPoint(m_reader.read<TimelinePoint>(), m_device.uploadBuffer(dst, data.data, data.size, dstOffset));
+        break;
+    }
+    case CaptureCommand::ReadBuffer: {
+        const CommandBuffer cmd  = map(m_reader.read<CommandBuffer>());
+        const Buffer        src  = map(m_reader.read<Buffer>());
+        const Buffer        dst  = map(m_reader.read<Buffer>());
+        const auto          args = m_reader.read<std::array<uint64_t, 3>>();
+        m_device.readBuffer(cmd, src, dst, args[0], args[1], args[2]);
+        break;
+    }
+    case CaptureCommand::WriteMappedData: {
+        const Buffer      buffer = map(m_reader.read<Buffer>());
+        const uint64_t    offset = m_reader.read<uint64_t>();
+        const CaptureBlob data   = m_reader.readBlob();
+        std::memcpy(static_cast<uint8_t*>(m_device.getBufferData(buffer)) + offset, data.data, data.size);
+        break;
+    }
+
+    // free methods
+    case CaptureCommand::Free: replayFree(); break;
+
+    // written by a newer version
+    default: m_reader.skip(); break;
+    }
+
+    return true;
+}
+
+void CaptureReplayer::replayFree() {
+    // see CaptureHandleTypes
+    switch (m_reader.read<uint8_t>()) {
+    case 0: free(m_reader.read<Window>()); break;
+    case 1: free(m_reader.read<Shader>()); break;
+    case 2: free(m_reader.read<RenderPass>()); break;
+    case 3: free(m_reader.read<Fence>()); break;
+    case 4: free(m_reader.read<Semaphore>()); break;
+    case 5: free(m_reader.read<Timeline>()); break;
+    case 6: free(m_reader.read<CommandBuffer>()); break;
+    case 7: free(m_reader.read<Buffer>()); break;
+    case 8: free(m_reader.read<DescriptorSetLayout>()); break;
+    case 9: free(m_reader.read<DescriptorSet>()); break;
+    default: throw std::runtime_error("Capture frees an unknown object type!");
+    }
+}
+
+uint32_t CaptureReplayer::mapImageIndex(Window window, uint32_t imageIndex) const {
+    // images acquired in the replay can come in a different order
+    auto it = m_imageIndices.find((uint64_t(window.value) << 32) | imageIndex);
+    return it != m_imageIndices.end() ? it->second : imageIndex;
+}
+
+TimelinePoint CaptureReplayer::mapPoint(const TimelinePoint& point) const {
+    // points returned by submissions are signaled on the timelines of the device, other values are set by the application
+    auto it = m_points.find({point.timeline.value, point.value});
+    return it != m_points.end() ? it->second : TimelinePoint(map(point.timeline), point.value);
+}
+
+void CaptureReplayer::bindPoint(const TimelinePoint& captured, const TimelinePoint& replayed) {
+    bind(captured.timeline, replayed.timeline);
+    m_points[{captured.timeline.value, captured.value}] = replayed;
+}
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "oz/gfx/vulkan/objects.h"
+#include "oz/gfx/vulkan/property_structs.h"
+
+#include <bit>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace oz::gfx::vk {
+
+class GraphicsDevice;
+
+// Recorded GraphicsDevice calls. The values are stored in capture files, new commands are only appended.
+enum class CaptureCommand : uint16_t {
+    End,
+    CreateWindow,
+    CreateCommandBuffer,
+    CreateCommandBundle,
+    CreateShader,
+    CreateRenderPass,
+    CreateDynamicRenderPass,
+    CreateSemaphore,
+    CreateTimeline,
+    CreateFence,
+    CreateBuffer,
+    CreateDescriptorSetLayout,
+    CreateDescriptorSet,
+    WaitIdle,
+    WaitFences,
+    ResetFences,
+    WaitTimeline,
+    SignalTimeline,
+    GetUniformRing,
+    GetCurrentCommandBuffer,
+    GetCurrentImage,
+    BeginFrame,
+    PresentFrame,
+    PollEvents,
+    BeginCmd,
+    EndCmd,
+    SubmitCmd,
+    BeginRenderPass,
+    EndRenderPass,
+    BeginRendering,
+    EndRendering,
+    Draw,
+    DrawIndexed,
+    BindPipeline,
+    BindVertexBuffer,
+    BindIndexBuffer,
+    BindDescriptorSet,
+    BeginBundle,
+    InvalidateBundle,
+    ExecuteBundles,
+    UpdateBuffer,
+    CopyBuffer,
+    UploadBuffer,
+    ReadBuffer,
+    WriteMappedData, // contents of host mapped memory written by the application since the last submission
+    Free,
+};
+
+// index of a handle type in capture files
+using CaptureHandleTypes =
+    std::tuple<Window, Shader, RenderPass, Fence, Semaphore, Timeline, CommandBuffer, Buffer, DescriptorSetLayout, DescriptorSet>;
+
+template <typename T, size_t I = 0>
+constexpr uint8_t getCaptureHandleType() {
+    static_assert(I < std::tuple_size_v<CaptureHandleTypes>, "Not a captured handle type!");
+    if constexpr (std::is_same_v<std::tuple_element_t<I, CaptureHandleTypes>, memory::Handle<T>>) {
+        return static_cast<uint8_t>(I);
+    } else {
+        return getCaptureHandleType<T, I + 1>();
+    }
+}
+
+// bytes stored inline in a record
+struct CaptureBlob {
+    const void* data = nullptr;
+    uint64_t    size = 0;
+};
+
+// Serializes GraphicsDevice calls into a capture file. Records are buffered and written once per frame, the capture
+// stops by itself after the requested number of frames.
+class CaptureWriter final {
+  public:
+    static constexpr uint32_t MAGIC   = 0x50435a4f; // "OZCP"
+    static constexpr uint32_t VERSION = 1;
+
+    CaptureWriter(const std::string& path, uint32_t frameCount);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&)            = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool isRecording() const { return m_isRecording; }
+
+    template <typename... Args>
+    void record(CaptureCommand command, const Args&... args) {
+        write(static_cast<uint16_t>(command));
+        const size_t sizeOffset = m_buffer.size();
+        write(uint32_t(0)); // payload size, patched below so readers can skip records
+        (write(args), ...);
+
+        const uint32_t payloadSize = static_cast<uint32_t>(m_buffer.size() - sizeOffset - sizeof(uint32_t));
+        std::memcpy(m_buffer.data() + sizeOffset, &payloadSize, sizeof(uint32_t));
+    }
+
+    // flushes the frame, the capture is finished after the last frame
+    void endFrame();
+
+    // calls made while a recorded call runs are part of it and not recorded themselves
+    void enter() { m_depth++; }
+    void leave() { m_depth--; }
+    bool isOutermost() const { return m_depth == 1; }
+
+    // mapped memory written by the application, stored before every submission
+    std::vector<Buffer> mappedBuffers;     // exposed through getBufferData
+    uint64_t            uniformOffset = 0; // end of the uniform ring range stored so far
+
+  private:
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Captured values have to be trivially copyable!");
+        writeBytes(&value, sizeof(T));
+    }
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        write(static_cast<uint32_t>(values.size()));
+        for (const T& value : values) {
+            write(value);
+        }
+    }
+    template <typename T>
+    void write(std::span<const T> values) {
+        write(static_cast<uint32_t>(values.size()));
+        for (const T& value : values) {
+            write(value);
+        }
+    }
+    void write(const std::string& value);
+    void write(const CaptureBlob& blob);
+    void write(const VertexLayoutInfo& vertexLayout);
+    void write(const DescriptorSetLayoutInfo& setLayout);
+    void write(const DescriptorSetInfo& setInfo);
+    void write(const SpecializationConstants& specialization);
+    void writeBytes(const void* data, size_t size);
+    void finish();
+
+  private:
+    std::ofstream        m_file;
+    std::vector<uint8_t> m_buffer; // records of the current frame
+    uint32_t             m_frameCount  = 0;
+    uint32_t             m_frameIndex  = 0;
+    uint32_t             m_depth       = 0;
+    bool                 m_isRecording = false;
+};
+
+// Marks a recorded call, see CaptureWriter::enter.
+class CaptureScope final {
+  public:
+    explicit CaptureScope(CaptureWriter* writer) : m_writer(writer != nullptr && writer->isRecording() ? writer : nullptr) {
+        if (m_writer != nullptr) {
+            m_writer->enter();
+        }
+    }
+    ~CaptureScope() {
+        if (m_writer != nullptr) {
+            m_writer->leave();
+        }
+    }
+
+    CaptureScope(const CaptureScope&)            = delete;
+    CaptureScope& operator=(const CaptureScope&) = delete;
+
+    bool isRecorded() const { return m_writer != nullptr && m_writer->isRecording() && m_writer->isOutermost(); }
+
+  private:
+    CaptureWriter* m_writer;
+};
+
+// Reads the records of a capture file, the whole file is loaded up front so replays do not wait on the disk.
+class CaptureReader final {
+  public:
+    explicit CaptureReader(const std::string& path);
+
+    // moves to the next record, false at the end of the capture
+    bool next(CaptureCommand& command);
+    // skips the rest of the current record
+    void skip();
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>, "Captured values have to be trivially copyable!");
+        std::array<std::byte, sizeof(T)> bytes;
+        readBytes(bytes.data(), sizeof(T));
+        return std::bit_cast<T>(bytes); // some captured types have no default constructor
+    }
+    template <typename T>
+    std::vector<T> readVector() {
+        std::vector<T> values;
+        const uint32_t count = read<uint32_t>();
+        values.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            values.push_back(read<T>());
+        }
+        return values;
+    }
+    std::string             readString();
+    CaptureBlob             readBlob(); // points into the loaded file
+    VertexLayoutInfo        readVertexLayout();
+    DescriptorSetLayoutInfo readDescriptorSetLayout();
+    DescriptorSetInfo       readDescriptorSet();
+    SpecializationConstants readSpecialization();
+
+    uint32_t getFrameCount() const { return m_frameCount; }
+
+  private:
+    void readBytes(void* data, size_t size);
+
+  private:
+    std::vector<char> m_data;
+    size_t            m_offset     = 0;
+    size_t            m_recordEnd  = 0;
+    uint32_t          m_frameCount = 0;
+};
+
+// Replays a capture on a device frame by frame. Captured handles are mapped to the objects created by the replay.
+class CaptureReplayer final {
+  public:
+    CaptureReplayer(GraphicsDevice& device, const std::string& path);
+
+    // replays the calls up to and including the next presentFrame, false once the capture is exhausted
+    bool     replayFrame();
+    uint32_t getFrameCount() const { return m_reader.getFrameCount(); }
+
+  private:
+    template <typename T>
+    using HandleMap = std::unordered_map<uint32_t, memory::Handle<T>>;
+
+    template <typename T>
+    memory::Handle<T> map(memory::Handle<T> captured) const;
+    template <typename T>
+    void bind(memory::Handle<T> captured, memory::Handle<T> replayed);
+    template <typename T>
+    void free(memory::Handle<T> captured);
+
+    // false once the frame is presented
+    bool replay(CaptureCommand command);
+    void replayFree();
+
+    // image indices and submission points depend on the device, they are mapped by the captured values
+    uint32_t      mapImageIndex(Window window, uint32_t imageIndex) const;
+    TimelinePoint mapPoint(const TimelinePoint& point) const;
+    void          bindPoint(const TimelinePoint& captured, const TimelinePoint& replayed);
+
+  private:
+    GraphicsDevice& m_device;
+    CaptureReader   m_reader;
+
+    std::tuple<HandleMap<WindowObject>,
+               HandleMap<ShaderObject>,
+               HandleMap<RenderPassObject>,
+               HandleMap<FenceObject>,
+               HandleMap<SemaphoreObject>,
+               HandleMap<TimelineObject>,
+               HandleMap<CommandBufferObject>,
+               HandleMap<BufferObject>,
+               HandleMap<DescriptorSetLayoutObject>,
+               HandleMap<DescriptorSetObject>>
+        m_handles;
+
+    std::unordered_map<uint32_t, Window>                   m_renderPassWindows; // captured render pass to captured window
+    std::unordered_map<uint64_t, uint32_t>                 m_imageIndices;      // captured window and image index to replayed index
+    std::map<std::pair<uint32_t, uint64_t>, TimelinePoint> m_points;            // captured submission points to replayed ones
+};
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "oz/core/memory/handle_pool.h"
+#include "oz/gfx/vulkan/common.h"
+
+#include <limits>
+
+namespace oz::gfx::vk {
+
+// Holds freed objects until the GPU work that might still reference them has completed.
+// Every entry carries a retire value, collect() destroys the entries whose retire value has been reached.
+// Entries pushed as PENDING wait for the submission that references them, resolvePending() gives them its value.
+template <typename... Ts>
+class DeletionQueue final {
+  public:
+    static constexpr uint64_t PENDING = std::numeric_limits<uint64_t>::max();
+
+    template <typename T>
+    void push(memory::Handle<T> handle, uint64_t retireValue) {
+        std::get<std::vector<Entry<T>>>(m_entries).push_back({handle, retireValue});
+    }
+
+    void resolvePending(uint64_t retireValue) {
+        std::apply([&](auto&... entries) { (resolveEntries(entries, retireValue), ...); }, m_entries);
+    }
+
+    template <typename F>
+    void collect(uint64_t completedValue, F&& destroy) {
+        std::apply([&](auto&... entries) { (collectEntries(entries, completedValue, destroy), ...); }, m_entries);
+    }
+
+    bool empty() const {
+        return std::apply([](const auto&... entries) { return (entries.empty() && ...); }, m_entries);
+    }
+
+  private:
+    template <typename T>
+    struct Entry {
+        memory::Handle<T> handle;
+        uint64_t          retireValue;
+    };
+
+    template <typename T, typename F>
+    static void collectEntries(std::vector<Entry<T>>& entries, uint64_t completedValue, F& destroy) {
+        // entries are pushed with non-decreasing retire values, so the retired ones form a prefix
+        size_t retiredCount = 0;
+        while (retiredCount < entries.size() && entries[retiredCount].retireValue <= completedValue) {
+            destroy(entries[retiredCount].handle);
+            retiredCount++;
+        }
+
+        entries.erase(entries.begin(), entries.begin() + retiredCount);
+    }
+
+    template <typename T>
+    static void resolveEntries(std::vector<Entry<T>>& entries, uint64_t retireValue) {
+        // pending entries are the latest ones, resolving them keeps the retire values non-decreasing
+        for (auto it = entries.rbegin(); it != entries.rend() && it->retireValue == PENDING; ++it) {
+            it->retireValue = retireValue;
+        }
+    }
+
+    std::tuple<std::vector<Entry<Ts>>...> m_entries;
+};
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -6,9 +6,18 @@ namespace oz::gfx::vk {
 
 enum class ShaderStage : uint8_t { Vertex = 0x00000001, Fragment = 0x00000010, Compute = 0x00000020 };
 
-enum class BufferType : uint8_t { Vertex, Uniform, Index, Staging };
+// readback buffers are host cached copy destinations, see GraphicsDevice::readBuffer
+enum class BufferType : uint8_t { Vertex, Uniform, Index, Staging, Storage, Readback };
 
-enum class BindingType : uint8_t { Uniform };
+enum class IndexType : uint8_t { Uint16, Uint32 };
+
+enum class BindingType : uint8_t { Uniform, UniformDynamic, Storage };
+
+// commands of a begun render pass are either recorded inline or all come from executed bundles
+enum class RenderPassContents : uint8_t { Inline, Bundles };
+
+// queues without a dedicated family on the device fall back to the graphics queue
+enum class QueueType : uint8_t { Graphics, Compute, Transfer };
 
 enum class Format {
     UNDEFINED                                      = 0,
@@ -0,0 +1,57 @@
+#include "oz/gfx/vulkan/frame_pacer.h"
+
+#include <thread>
+
+namespace oz::gfx::vk {
+
+namespace {
+static constexpr double PERIOD_SMOOTHING    = 0.1;
+static constexpr double MARGIN_GROWTH       = 1.5;
+static constexpr double MARGIN_DECAY        = 0.98;
+static constexpr double MISSED_PERIOD_RATIO = 1.5;
+} // namespace
+
+double FramePacer::pace() {
+    m_isPaced = false;
+    if (!m_hasLastReadyTime || m_periodMs <= 0.0) {
+        return 0.0;
+    }
+
+    const Clock::time_point now        = Clock::now();
+    const Clock::time_point wakeUpTime = m_lastReadyTime + std::chrono::duration_cast<Clock::duration>(
+                                                               std::chrono::duration<double, std::milli>(m_periodMs - m_marginMs));
+    if (wakeUpTime <= now) {
+        return 0.0; // cpu bound, the frame is already late
+    }
+
+    std::this_thread::sleep_until(wakeUpTime);
+    m_isPaced = true;
+
+    return std::chrono::duration<double, std::milli>(Clock::now() - now).count();
+}
+
+void FramePacer::markReady(Clock::time_point readyTime, double waitMs) {
+    const bool   isBlocked  = waitMs > BLOCKED_THRESHOLD;
+    const double intervalMs = std::chrono::duration<double, std::milli>(readyTime - m_lastReadyTime).count();
+
+    // a paced frame that woke up just too late waits for the following period, the interval then spans several
+    const bool isMissed = m_isPaced && m_periodMs > 0.0 && intervalMs > m_periodMs * MISSED_PERIOD_RATIO;
+
+    // only consecutive blocked frames measure the gpu or display rate, the others became ready when the cpu asked
+    if (m_hasLastReadyTime && isBlocked && m_wasLastBlocked && !isMissed) {
+        m_periodMs = m_periodMs <= 0.0 ? intervalMs : m_periodMs + (intervalMs - m_periodMs) * PERIOD_SMOOTHING;
+    }
+
+    // a paced frame that did not block or missed its period overslept
+    if (m_isPaced) {
+        m_marginMs = isBlocked && !isMissed ? m_marginMs * MARGIN_DECAY : m_marginMs * MARGIN_GROWTH;
+        m_marginMs = std::clamp(m_marginMs, MIN_MARGIN_MS, MAX_MARGIN_MS);
+    }
+
+    m_lastReadyTime    = readyTime;
+    m_hasLastReadyTime = true;
+    m_wasLastBlocked   = isBlocked;
+    m_isPaced          = false;
+}
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "oz/gfx/vulkan/common.h"
+
+namespace oz::gfx::vk {
+
+// Predicts when the next frame in flight becomes available and sleeps until just before it, so input can be sampled
+// as late as possible without delaying the frame. The period is learned from frames that had to block, the safety
+// margin grows when a paced frame did not block, i.e. the pacer overslept, and shrinks while frames still block.
+class FramePacer final {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr double MIN_MARGIN_MS     = 0.5;
+    static constexpr double MAX_MARGIN_MS     = 4.0;
+    static constexpr double BLOCKED_THRESHOLD = 0.05; // waits below this many milliseconds count as not blocked
+
+    // sleeps until the predicted availability minus the margin, returns the slept milliseconds
+    double pace();
+    // the frame in flight became available at readyTime after blocking for waitMs
+    void   markReady(Clock::time_point readyTime, double waitMs);
+
+    double getPeriodMs() const { return m_periodMs; }
+    double getMarginMs() const { return m_marginMs; }
+
+  private:
+    Clock::time_point m_lastReadyTime;
+    bool              m_hasLastReadyTime = false;
+    bool              m_wasLastBlocked   = false;
+    bool              m_isPaced          = false; // the current frame slept in pace
+    double            m_periodMs         = 0.0;   // smoothed interval between frames that blocked
+    double            m_marginMs         = 2.0;
+};
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "oz/gfx/vulkan/graphics_device.h"
 #include "oz/core/file/file.h"
+#include "oz/gfx/vulkan/capture.h"
+#include "oz/gfx/vulkan/host_allocator.h"
 #include "oz/gfx/vulkan/objects_internal.h"
+#include "oz/gfx/vulkan/render_queue.h"
 
 #include <cstring>
 
@@ -8,12 +11,32 @@ namespace oz::gfx::vk {
 
 #define OZ_VK_ASSERT(result) assert(result == VK_SUCCESS)
 
+// records a call into the running capture, calls made by other recorded calls are part of them and not recorded
+#define OZ_CAPTURE_SCOPE() CaptureScope captureScope(m_capture.get())
+#define OZ_CAPTURE(COMMAND, ...)                                   \
+    if (captureScope.isRecorded()) {                               \
+        m_capture->record(CaptureCommand::COMMAND, ##__VA_ARGS__); \
+    }
+
 #if defined(__APPLE__)
     #define OZ_REQUIRES_VK_PORTABILITY_SUBSET
 #endif
 
 namespace {
-static constexpr int FRAMES_IN_FLIGHT = 1;
+static constexpr int      FRAMES_IN_FLIGHT          = 1;
+static constexpr uint64_t UNIFORM_RING_REGION_SIZE = 4 * 1024 * 1024; // per frame in flight
+static constexpr uint64_t STAGING_CHUNK_SIZE       = 8 * 1024 * 1024; // largest upload submission
+static constexpr uint32_t STAGING_CHUNK_COUNT      = 4;               // chunks in flight, the ring holds one per chunk
+
+// counters of the pipeline statistics queries, in the order of PipelineStats
+static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+// indices of the async queues, see QueueType
+static constexpr uint32_t ASYNC_COMPUTE  = 0;
+static constexpr uint32_t ASYNC_TRANSFER = 1;
 
 static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT      messageSeverity,
                                                     VkDebugUtilsMessageTypeFlagsEXT             messageType,
@@ -26,9 +49,480 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityF
     return VK_FALSE;
 }
 
+static VkDescriptorType getVkDescriptorType(BindingType type) {
+    switch (type) {
+    case BindingType::Uniform:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    case BindingType::UniformDynamic:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    case BindingType::Storage:
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    default:
+        throw std::runtime_error("Not supported binding type!");
+    }
+}
+
+// windows have a fixed size and their swap chains are not recreated, a suboptimal swap chain can still be used
+static void checkSwapChainResult(VkResult result) {
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        throw std::runtime_error("Swap chain is out of date!");
+    }
+    assert(result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR);
+}
+
+// render queue keys hold handle indices in fixed bit fields, larger pools would let indices spill into the other fields
+static const ObjectCapacityInfo& checkObjectCapacities(const ObjectCapacityInfo& capacities) {
+    if (capacities.renderPasses > (1u << RenderQueue::PIPELINE_BITS) || capacities.descriptorSets > (1u << RenderQueue::MATERIAL_BITS) ||
+        capacities.buffers > (1u << RenderQueue::MESH_BITS)) {
+        throw std::runtime_error("Object capacity exceeds the render queue key bits!");
+    }
+    return capacities;
+}
+
+static const char* getDeviceTypeName(VkPhysicalDeviceType type) {
+    switch (type) {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+        return "Discrete GPU";
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+        return "Integrated GPU";
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+        return "Virtual GPU";
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:
+        return "CPU";
+    default:
+        return "Other";
+    }
+}
+
+// first family supporting every required flag and none of the excluded ones
+static std::optional<uint32_t> findQueueFamily(const std::vector<VkQueueFamilyProperties>& queueFamilies,
+                                               VkQueueFlags                                 requiredFlags,
+                                               VkQueueFlags                                 excludedFlags) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(queueFamilies.size()); i++) {
+        const VkQueueFlags flags = queueFamilies[i].queueFlags;
+        if (queueFamilies[i].queueCount > 0 && (flags & requiredFlags) == requiredFlags && (flags & excludedFlags) == 0) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+// the device type dominates, then optional features, then the size of the largest device local heap
+static uint64_t scorePhysicalDevice(VkPhysicalDevice                            physicalDevice,
+                                    const VkPhysicalDeviceProperties&           properties,
+                                    const std::vector<VkQueueFamilyProperties>& queueFamilies,
+                                    bool                                        isDynamicRenderingSupported) {
+    uint64_t typeScore = 0;
+    switch (properties.deviceType) {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+        typeScore = 4;
+        break;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+        typeScore = 3;
+        break;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+        typeScore = 2;
+        break;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:
+        typeScore = 1;
+        break;
+    default:
+        break;
+    }
+
+    uint64_t featureScore = 0;
+    if (isDynamicRenderingSupported) {
+        featureScore += 2;
+    }
+    if (findQueueFamily(queueFamilies, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT).has_value()) {
+        featureScore += 1;
+    }
+
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    uint64_t deviceLocalSize = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            deviceLocalSize = std::max<uint64_t>(deviceLocalSize, memoryProperties.memoryHeaps[i].size);
+        }
+    }
+    const uint64_t memoryScore = std::min<uint64_t>(deviceLocalSize >> 20, 999'999); // MiB
+
+    return typeScore * 10'000'000 + featureScore * 1'000'000 + memoryScore;
+}
+
+// binds the pipeline and sets viewport and scissor, skips the calls if the state is already bound
+static void bindPipelineState(CommandBufferObject& cmd, const RenderPassObject& renderPass) {
+    if (cmd.vkBoundPipeline != renderPass.vkGraphicsPipeline) {
+        vkCmdBindPipeline(cmd.vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPass.vkGraphicsPipeline);
+        cmd.vkBoundPipeline = renderPass.vkGraphicsPipeline;
+        cmd.stats.pipeline.issued++;
+
+        // descriptor sets bound with another layout may be disturbed
+        if (cmd.vkBoundPipelineLayout != renderPass.vkPipelineLayout) {
+            cmd.vkBoundPipelineLayout = renderPass.vkPipelineLayout;
+            cmd.vkBoundDescriptorSets = {};
+        }
+    } else {
+        cmd.stats.pipeline.elided++;
+    }
+
+    // viewport and scissor are dynamic states of every pipeline and persist across render passes
+    // inside beginRendering they cover the rendering area instead of the extent the pipeline was created for
+    const VkExtent2D extent = cmd.vkRenderingExtent.width != 0 ? cmd.vkRenderingExtent : renderPass.vkExtent;
+    if (cmd.vkBoundExtent.width != extent.width || cmd.vkBoundExtent.height != extent.height) {
+        VkViewport viewport{};
+        viewport.x        = 0.0f;
+        viewport.y        = 0.0f;
+        viewport.width    = static_cast<float>(extent.width);
+        viewport.height   = static_cast<float>(extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(cmd.vkCommandBuffer, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = extent;
+        vkCmdSetScissor(cmd.vkCommandBuffer, 0, 1, &scissor);
+
+        cmd.vkBoundExtent = extent;
+        cmd.stats.viewportScissor.issued++;
+    } else {
+        cmd.stats.viewportScissor.elided++;
+    }
+}
+
+static VkPipelineLayout createVkPipelineLayout(VkDevice                               vkDevice,
+                                               const VkAllocationCallbacks*           vkAllocator,
+                                               std::span<const VkDescriptorSetLayout> vkDescriptorSetLayouts) {
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount         = vkDescriptorSetLayouts.size();
+    pipelineLayoutInfo.pSetLayouts            = vkDescriptorSetLayouts.data();
+    pipelineLayoutInfo.pushConstantRangeCount = 0;
+    pipelineLayoutInfo.pPushConstantRanges    = nullptr;
+
+    VkPipelineLayout vkPipelineLayout;
+    OZ_VK_ASSERT(vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, vkAllocator, &vkPipelineLayout));
+
+    return vkPipelineLayout;
+}
+
+// shader stages of a graphics pipeline, the specialization infos point into the merged constants
+struct PipelineStages final {
+    static constexpr uint32_t COUNT = 2;
+
+    std::array<VkPipelineShaderStageCreateInfo, COUNT>       vkStages              = {};
+    std::array<SpecializationConstants, COUNT>               specializations;
+    std::array<std::vector<VkSpecializationMapEntry>, COUNT> vkMapEntries;
+    std::array<VkSpecializationInfo, COUNT>                  vkSpecializationInfos = {};
+    std::array<uint64_t, COUNT>                              codeHashes            = {};
+
+    // the constants of the pipeline override the defaults of the shaders
+    PipelineStages(const ShaderObject& vertexShader, const ShaderObject& fragmentShader, const SpecializationConstants& specialization) {
+        const ShaderObject* shaders[COUNT] = {&vertexShader, &fragmentShader};
+
+        for (uint32_t i = 0; i < COUNT; i++) {
+            SpecializationConstants& merged = specializations[i];
+            merged                          = shaders[i]->specialization;
+            for (const auto& entry : specialization.entries) {
+                const uint8_t* value    = specialization.data.data() + entry.offset;
+                auto           existing = std::find_if(merged.entries.begin(), merged.entries.end(), [&](const auto& mergedEntry) {
+                    return mergedEntry.constantId == entry.constantId;
+                });
+
+                if (existing != merged.entries.end()) {
+                    assert(existing->size == entry.size); // the type of a constant can not change
+                    std::memcpy(merged.data.data() + existing->offset, value, entry.size);
+                } else {
+                    uint32_t offset = static_cast<uint32_t>(merged.data.size());
+                    merged.entries.push_back({entry.constantId, offset, entry.size});
+                    merged.data.insert(merged.data.end(), value, value + entry.size);
+                }
+            }
+
+            vkStages[i]   = shaders[i]->vkPipelineShaderStageCreateInfo;
+            codeHashes[i] = shaders[i]->codeHash;
+            if (merged.empty()) {
+                continue;
+            }
+
+            for (const auto& entry : merged.entries) {
+                vkMapEntries[i].push_back({entry.constantId, entry.offset, entry.size});
+            }
+
+            VkSpecializationInfo& vkSpecializationInfo = vkSpecializationInfos[i];
+            vkSpecializationInfo.mapEntryCount         = static_cast<uint32_t>(vkMapEntries[i].size());
+            vkSpecializationInfo.pMapEntries           = vkMapEntries[i].data();
+            vkSpecializationInfo.dataSize              = merged.data.size();
+            vkSpecializationInfo.pData                 = merged.data.data();
+            vkStages[i].pSpecializationInfo            = &vkSpecializationInfo;
+        }
+    }
+
+    PipelineStages(const PipelineStages&)            = delete;
+    PipelineStages& operator=(const PipelineStages&) = delete;
+};
+
+// key of the pipeline cache, built from contents instead of handles since freed handles can be reused
+static uint64_t getPipelineKey(const PipelineStages&                           stages,
+                               const VertexLayoutInfo&                         vertexLayout,
+                               std::span<const DescriptorSetLayoutObject* const> descriptorSetLayouts,
+                               const std::vector<VkFormat>&                    vkColorFormats,
+                               bool                                            isDynamic) {
+    auto combine = [](uint64_t key, const void* data, size_t size) { return file::hash(data, size, key); };
+
+    uint64_t key = combine(0, &isDynamic, sizeof(isDynamic));
+
+    // shaders with their specialization constants
+    for (uint32_t i = 0; i < PipelineStages::COUNT; i++) {
+        const SpecializationConstants& specialization = stages.specializations[i];
+
+        key = combine(key, &stages.codeHashes[i], sizeof(uint64_t));
+        key = combine(key, &stages.vkStages[i].stage, sizeof(VkShaderStageFlagBits));
+        key = combine(key, specialization.entries.data(), specialization.entries.size() * sizeof(SpecializationConstants::Entry));
+        key = combine(key, specialization.data.data(), specialization.data.size());
+    }
+
+    // vertex layout
+    key = combine(key, &vertexLayout.vertexSize, sizeof(uint32_t));
+    for (const auto& attribute : vertexLayout.vertexLayoutAttributes) {
+        uint64_t offset = attribute.offset;
+        key             = combine(key, &offset, sizeof(uint64_t));
+        key             = combine(key, &attribute.format, sizeof(Format));
+    }
+
+    // descriptor set layouts, separated by their binding counts
+    for (const DescriptorSetLayoutObject* layout : descriptorSetLayouts) {
+        uint32_t bindingCount = static_cast<uint32_t>(layout->vkDescriptorTypes.size());
+        key                   = combine(key, &bindingCount, sizeof(uint32_t));
+        key                   = combine(key, layout->vkDescriptorTypes.data(), bindingCount * sizeof(VkDescriptorType));
+    }
+
+    // attachment formats, render passes with matching formats are compatible
+    key = combine(key, vkColorFormats.data(), vkColorFormats.size() * sizeof(VkFormat));
+
+    return key;
+}
+
+// creates the graphics pipeline shared by render pass and dynamic rendering passes
+static VkPipeline createVkGraphicsPipeline(VkDevice                               vkDevice,
+                                           const VkAllocationCallbacks*           vkAllocator,
+                                           VkPipelineCache                        vkPipelineCache,
+                                           const VkPipelineShaderStageCreateInfo* stages,
+                                           const VertexLayoutInfo&                vertexLayout,
+                                           VkPipelineLayout                       vkPipelineLayout,
+                                           VkRenderPass                           vkRenderPass,
+                                           VkExtent2D                             extent,
+                                           const void*                            pNext) {
+    // create vertex state input info
+    // TODO: store at the VertexLayout struct instead of re-creating for each render pass
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+    VkVertexInputBindingDescription      bindingDescription{};
+    memory::InlineVector<VkVertexInputAttributeDescription, MAX_VERTEX_ATTRIBUTES> attributeDescriptions;
+    {
+        if (vertexLayout.vertexLayoutAttributes.size() == 0) {
+            vertexInputInfo.vertexBindingDescriptionCount   = 0;
+            vertexInputInfo.vertexAttributeDescriptionCount = 0;
+            vertexInputInfo.pVertexBindingDescriptions      = nullptr;
+            vertexInputInfo.pVertexAttributeDescriptions    = nullptr;
+        } else {
+            for (int i = 0; i < vertexLayout.vertexLayoutAttributes.size(); i++) {
+                VkVertexInputAttributeDescription vkAttributeDescription{};
+                auto&                             attribute = vertexLayout.vertexLayoutAttributes[i];
+
+                vkAttributeDescription.binding  = 0;
+                vkAttributeDescription.location = i;
+                vkAttributeDescription.format   = (VkFormat)attribute.format; // TODO: do not cast, use conversion util
+                vkAttributeDescription.offset   = attribute.offset;
+                attributeDescriptions.push_back(vkAttributeDescription);
+            }
+            bindingDescription.binding   = 0;
+            bindingDescription.stride    = vertexLayout.vertexSize;
+            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+            vertexInputInfo.vertexBindingDescriptionCount   = 1;
+            vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+            vertexInputInfo.pVertexBindingDescriptions      = &bindingDescription;
+            vertexInputInfo.pVertexAttributeDescriptions    = attributeDescriptions.data();
+        }
+    }
+
+    // create graphics pipeline
+    VkPipeline vkGraphicsPipeline;
+    {
+        std::vector<VkDynamicState> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+
+        VkPipelineDynamicStateCreateInfo dynamicState{};
+        dynamicState.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+        dynamicState.pDynamicStates    = dynamicStates.data();
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
+        inputAssembly.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+        VkViewport viewport{};
+        viewport.x        = 0.0f;
+        viewport.y        = 0.0f;
+        viewport.width    = static_cast<float>(extent.width);
+        viewport.height   = static_cast<float>(extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+
+        VkRect2D scissor{};
+        scissor.offset = {0, 0};
+        scissor.extent = extent;
+
+        VkPipelineViewportStateCreateInfo viewportState{};
+        viewportState.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewportState.viewportCount = 1;
+        viewportState.pViewports    = &viewport;
+        viewportState.scissorCount  = 1;
+        viewportState.pScissors     = &scissor;
+
+        VkPipelineRasterizationStateCreateInfo rasterizer{};
+        rasterizer.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterizer.depthClampEnable        = VK_FALSE;
+        rasterizer.rasterizerDiscardEnable = VK_FALSE;
+        rasterizer.polygonMode             = VK_POLYGON_MODE_FILL;
+        rasterizer.lineWidth               = 1.0f;
+        rasterizer.cullMode                = VK_CULL_MODE_BACK_BIT;
+        rasterizer.frontFace               = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        rasterizer.depthBiasEnable = VK_FALSE;
+
+        VkPipelineMultisampleStateCreateInfo multisampling{};
+        multisampling.sType                = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisampling.sampleShadingEnable  = VK_FALSE;
+        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask =
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable         = VK_FALSE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;  // Optional
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
+        colorBlendAttachment.colorBlendOp        = VK_BLEND_OP_ADD;      // Optional
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;  // Optional
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
+        colorBlendAttachment.alphaBlendOp        = VK_BLEND_OP_ADD;      // Optional
+
+        VkPipelineColorBlendStateCreateInfo colorBlending{};
+        colorBlending.sType             = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        colorBlending.logicOpEnable     = VK_FALSE;
+        colorBlending.logicOp           = VK_LOGIC_OP_COPY; // Optional
+        colorBlending.attachmentCount   = 1;
+        colorBlending.pAttachments      = &colorBlendAttachment;
+        colorBlending.blendConstants[0] = 0.0f; // Optional
+        colorBlending.blendConstants[1] = 0.0f; // Optional
+        colorBlending.blendConstants[2] = 0.0f; // Optional
+        colorBlending.blendConstants[3] = 0.0f; // Optional
+
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType      = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = 2;
+
+        pipelineInfo.pNext      = pNext;
+        pipelineInfo.pStages    = stages;
+        pipelineInfo.pVertexInputState   = &vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState      = &viewportState;
+        pipelineInfo.pRasterizationState = &rasterizer;
+        pipelineInfo.pMultisampleState   = &multisampling;
+        pipelineInfo.pColorBlendState    = &colorBlending;
+        pipelineInfo.pDynamicState       = &dynamicState;
+        pipelineInfo.layout              = vkPipelineLayout;
+        pipelineInfo.renderPass          = vkRenderPass; // null for dynamic rendering, formats come from pNext
+        pipelineInfo.subpass             = 0;
+
+        OZ_VK_ASSERT(vkCreateGraphicsPipelines(vkDevice, vkPipelineCache, 1, &pipelineInfo, vkAllocator, &vkGraphicsPipeline));
+    }
+
+    return vkGraphicsPipeline;
+}
+
 } // namespace
 
-GraphicsDevice::GraphicsDevice(const bool enableValidationLayers) {
+template <typename T>
+memory::HandlePool<T>& GraphicsDevice::pool() const {
+    return std::get<memory::HandlePool<T>>(m_objects->pools);
+}
+
+template <typename T>
+T& GraphicsDevice::get(memory::Handle<T> handle) const {
+    return pool<T>().get(handle);
+}
+
+template <typename T>
+void GraphicsDevice::destroy(memory::Handle<T> handle) const {
+    if (!handle) {
+        return;
+    }
+
+    get(handle).free(m_device, m_vkAllocator);
+    pool<T>().destroy(handle);
+}
+
+template <typename T>
+void GraphicsDevice::retire(memory::Handle<T> handle) const {
+    OZ_CAPTURE_SCOPE();
+
+    if (!handle) {
+        return;
+    }
+    OZ_CAPTURE(Free, getCaptureHandleType<T>(), handle);
+
+    // the object may still be recorded, it is retired with the submission that resolves the pending entries, see submitCmd
+    m_objects->deletionQueue.push(handle, m_objects->deletionQueue.PENDING);
+}
+
+void GraphicsDevice::collectRetiredObjects(uint64_t completedValue) const {
+    m_objects->deletionQueue.collect(completedValue, [this](auto handle) { destroy(handle); });
+}
+
+GraphicsDevice::AsyncQueue* GraphicsDevice::getAsyncQueue(QueueType queueType) {
+    AsyncQueue* asyncQueue = nullptr;
+    if (queueType == QueueType::Compute) {
+        asyncQueue = &m_asyncQueues[ASYNC_COMPUTE];
+    } else if (queueType == QueueType::Transfer) {
+        asyncQueue = &m_asyncQueues[ASYNC_TRANSFER];
+    }
+    return asyncQueue != nullptr && asyncQueue->family != VK_QUEUE_FAMILY_IGNORED ? asyncQueue : nullptr;
+}
+
+uint64_t GraphicsDevice::getCompletedSubmitValue() const {
+    // submit values are shared by the queues, a queue with pending work holds back every later value
+    uint64_t completedValue = m_submitValue;
+
+    const uint64_t graphicsValue = getTimelineValue(m_submitTimeline);
+    if (graphicsValue < m_graphicsSubmitValue) {
+        completedValue = std::min(completedValue, graphicsValue);
+    }
+    for (const AsyncQueue& queue : m_asyncQueues) {
+        if (queue.family == VK_QUEUE_FAMILY_IGNORED) {
+            continue;
+        }
+        const uint64_t queueValue = getTimelineValue(queue.timeline);
+        if (queueValue < queue.submittedValue) {
+            completedValue = std::min(completedValue, queueValue);
+        }
+    }
+    return completedValue;
+}
+
+GraphicsDevice::GraphicsDevice(const bool                 enableValidationLayers,
+                               const DeviceSelectionInfo& deviceSelection,
+                               const CaptureInfo&         capture,
+                               const HostAllocatorInfo&   hostAllocator,
+                               const ObjectCapacityInfo&  objectCapacities)
+    : m_objects(std::make_unique<ObjectPools>(checkObjectCapacities(objectCapacities))) {
+    // host allocations of the driver
+    if (hostAllocator.isEnabled) {
+        m_hostAllocator = std::make_unique<HostAllocator>(hostAllocator.isArenaEnabled);
+        m_vkAllocator   = m_hostAllocator->getCallbacks();
+    }
+
     // init glfw
     // TODO: seperate glfw logic
     glfwInit();
@@ -96,7 +590,7 @@ GraphicsDevice::GraphicsDevice(const bool enableValidationLayers) {
         appInfo.pApplicationName   = "oz";
         appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
         appInfo.pEngineName        = "oz";
-        appInfo.apiVersion         = VK_API_VERSION_1_0;
+        appInfo.apiVersion         = VK_API_VERSION_1_3; // devices below 1.3 are still accepted, see device selection
 
         // instance create info
         VkInstanceCreateInfo createInfo{};
@@ -109,13 +603,13 @@ GraphicsDevice::GraphicsDevice(const bool enableValidationLayers) {
         createInfo.ppEnabledExtensionNames = requiredInstanceExtensions.data();
         createInfo.flags                   = VK_INSTANCE_CREATE_ENUMERATE_PORTABILITY_BIT_KHR;
 
-        OZ_VK_ASSERT(vkCreateInstance(&createInfo, nullptr, &m_instance));
+        OZ_VK_ASSERT(vkCreateInstance(&createInfo, m_vkAllocator, &m_instance));
     }
 
     // create debug messenger
     if (enableValidationLayers) {
         auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_instance, "vkCreateDebugUtilsMessengerEXT");
-        OZ_VK_ASSERT(func(m_instance, &debugCreateInfo, nullptr, &m_debugMessenger));
+        OZ_VK_ASSERT(func(m_instance, &debugCreateInfo, m_vkAllocator, &m_debugMessenger));
     }
 
     // pick physical device
@@ -128,37 +622,21 @@ GraphicsDevice::GraphicsDevice(const bool enableValidationLayers) {
 
         std::cout << "Found " << deviceCount << " physical device(s):\n";
 
-        bool isGPUFound = false;
-        for (const auto& physicalDevice : physicalDevices) {
+        std::optional<uint32_t> selectedIndex;
+        uint64_t                selectedScore = 0;
+        for (uint32_t deviceIndex = 0; deviceIndex < deviceCount; deviceIndex++) {
+            VkPhysicalDevice physicalDevice = physicalDevices[deviceIndex];
+
             // Query and print device properties
             VkPhysicalDeviceProperties deviceProperties;
             vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
 
-            std::string deviceTypeStr;
-            switch (deviceProperties.deviceType) {
-                case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: deviceTypeStr = "Discrete GPU"; break;
-                case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: deviceTypeStr = "Integrated GPU"; break;
-                case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: deviceTypeStr = "Virtual GPU"; break;
-                case VK_PHYSICAL_DEVICE_TYPE_CPU: deviceTypeStr = "CPU"; break;
-                default: deviceTypeStr = "Other"; break;
-            }
-
-            std::cout << "  - " << deviceProperties.deviceName << " (" << deviceTypeStr << ")\n";
-
             // check queue family support
-            std::optional<uint32_t> graphicsFamily;
-            uint32_t                queueFamilyCount = 0;
+            uint32_t queueFamilyCount = 0;
             vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
-            m_queueFamilies.resize(queueFamilyCount);
-            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, m_queueFamilies.data());
-            for (int i = 0; i < m_queueFamilies.size(); i++) {
-                const auto& queueFamily = m_queueFamilies[i];
-                if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
-                    graphicsFamily = i;
-                    break;
-                }
-            }
-            bool areQueueFamiliesSupported = graphicsFamily.has_value();
+            std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+            vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+            bool areQueueFamiliesSupported = findQueueFamily(queueFamilies, VK_QUEUE_GRAPHICS_BIT, 0).has_value();
 
             // check extension support
             uint32_t extensionCount;
@@ -175,49 +653,172 @@ GraphicsDevice::GraphicsDevice(const bool enableValidationLayers) {
             }
             bool areExtensionsSupported = extensionMatchCount == (uint32_t)requiredExtensions.size();
 
-            // check if the GPU is suitable
-            bool isSuitable = areExtensionsSupported && areQueueFamiliesSupported;
+            // optional dynamic rendering, core since 1.3
+            bool isDynamicRenderingAvailable = deviceProperties.apiVersion >= VK_API_VERSION_1_3;
+            for (const auto& availableExtension : availableExtensions) {
+                if (strcmp(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, availableExtension.extensionName) == 0) {
+                    isDynamicRenderingAvailable = true;
+                }
+            }
+
+            // check feature support
+            bool areFeaturesSupported        = false;
+            bool isDynamicRenderingSupported = false;
+            if (deviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+                VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures{};
+                dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+
+                VkPhysicalDeviceVulkan12Features vulkan12Features{};
+                vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+                vulkan12Features.pNext = isDynamicRenderingAvailable ? &dynamicRenderingFeatures : nullptr;
 
+                VkPhysicalDeviceFeatures2 features{};
+                features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+                features.pNext = &vulkan12Features;
+                vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+                areFeaturesSupported        = vulkan12Features.timelineSemaphore == VK_TRUE;
+                isDynamicRenderingSupported = dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+            }
+
+            // check if the GPU is suitable and score it
+            bool     isSuitable = areExtensionsSupported && areQueueFamiliesSupported && areFeaturesSupported;
+            uint64_t score      = isSuitable ? scorePhysicalDevice(physicalDevice, deviceProperties, queueFamilies, isDynamicRenderingSupported) : 0;
+
+            std::cout << "  - [" << deviceIndex << "] " << deviceProperties.deviceName << " (" << getDeviceTypeName(deviceProperties.deviceType)
+                      << ")";
             if (isSuitable) {
-                std::cout << "  -> Selected device: " << deviceProperties.deviceName << "\n";
-                m_graphicsFamily = graphicsFamily.value();
-                m_physicalDevice = physicalDevice;
-                isGPUFound       = true;
-                break;
+                std::cout << " score " << score << "\n";
+            } else {
+                std::cout << " not suitable\n";
+            }
+
+            // an override replaces the scoring
+            bool isRequested = true;
+            if (deviceSelection.index.has_value()) {
+                isRequested = deviceSelection.index.value() == deviceIndex;
+            } else if (!deviceSelection.name.empty()) {
+                isRequested = strstr(deviceProperties.deviceName, deviceSelection.name.c_str()) != nullptr;
             }
+
+            if (isSuitable && isRequested && (!selectedIndex.has_value() || score > selectedScore)) {
+                selectedIndex                 = deviceIndex;
+                selectedScore                 = score;
+                m_physicalDevice              = physicalDevice;
+                m_physicalDeviceProperties    = deviceProperties;
+                m_isDynamicRenderingSupported = isDynamicRenderingSupported;
+                m_queueFamilies               = std::move(queueFamilies);
+            }
+        }
+
+        if (!selectedIndex.has_value()) {
+            throw std::runtime_error("No suitable physical device found!");
         }
-        assert(isGPUFound);
+        std::cout << "  -> Selected device: " << m_physicalDeviceProperties.deviceName << "\n";
+
+        // queue families, dedicated compute and transfer families run concurrently with graphics
+        m_graphicsFamily = findQueueFamily(m_queueFamilies, VK_QUEUE_GRAPHICS_BIT, 0).value();
+
+        std::optional<uint32_t> computeFamily  = findQueueFamily(m_queueFamilies, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+        std::optional<uint32_t> transferFamily =
+            findQueueFamily(m_queueFamilies, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+        m_asyncQueues[ASYNC_COMPUTE].family       = computeFamily.value_or(VK_QUEUE_FAMILY_IGNORED);
+        m_asyncQueues[ASYNC_COMPUTE].isDedicated  = computeFamily.has_value();
+        m_asyncQueues[ASYNC_TRANSFER].family      = transferFamily.value_or(computeFamily.value_or(VK_QUEUE_FAMILY_IGNORED));
+        m_asyncQueues[ASYNC_TRANSFER].isDedicated = transferFamily.has_value();
+
+        m_bufferQueueFamilies = {m_graphicsFamily};
+        for (const AsyncQueue& queue : m_asyncQueues) {
+            if (queue.family != VK_QUEUE_FAMILY_IGNORED &&
+                std::find(m_bufferQueueFamilies.begin(), m_bufferQueueFamilies.end(), queue.family) == m_bufferQueueFamilies.end()) {
+                m_bufferQueueFamilies.push_back(queue.family);
+            }
+        }
+
+        // transfers without a dedicated family still run concurrently with graphics on the compute family
+        const char* transferQueueName = transferFamily.has_value() ? "yes" : (computeFamily.has_value() ? "no, compute queue fallback" : "no");
+        std::cout << "  -> Dedicated compute queue: " << (computeFamily.has_value() ? "yes" : "no")
+                  << ", dedicated transfer queue: " << transferQueueName << "\n";
     }
     // create logical device
     {
+        // one queue per queue type, queue types sharing a family get their own queue while the family has enough
+        std::vector<uint32_t> familyQueueCounts(m_queueFamilies.size(), 0);
+        familyQueueCounts[m_graphicsFamily] = 1;
+        for (AsyncQueue& queue : m_asyncQueues) {
+            if (queue.family != VK_QUEUE_FAMILY_IGNORED) {
+                queue.queueIndex = std::min(familyQueueCounts[queue.family], m_queueFamilies[queue.family].queueCount - 1);
+                familyQueueCounts[queue.family] = queue.queueIndex + 1;
+            }
+        }
+
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-        float                                queuePriority = 1.0f;
-        for (uint32_t queueFamily : std::vector<uint32_t>{m_graphicsFamily}) {
+        std::vector<float>                   queuePriorities(3, 1.0f);
+        for (uint32_t queueFamily = 0; queueFamily < static_cast<uint32_t>(familyQueueCounts.size()); queueFamily++) {
+            if (familyQueueCounts[queueFamily] == 0) {
+                continue;
+            }
             VkDeviceQueueCreateInfo queueCreateInfo{};
             queueCreateInfo.sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
             queueCreateInfo.queueFamilyIndex = queueFamily;
-            queueCreateInfo.queueCount       = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
+            queueCreateInfo.queueCount       = familyQueueCounts[queueFamily];
+            queueCreateInfo.pQueuePriorities = queuePriorities.data();
             queueCreateInfos.push_back(queueCreateInfo);
         }
 
+        // pipeline statistics are queried around the frame command buffer, the bundles executed in it inherit the query
+        VkPhysicalDeviceFeatures supportedFeatures;
+        vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+        m_isPipelineStatsSupported = supportedFeatures.pipelineStatisticsQuery == VK_TRUE && supportedFeatures.inheritedQueries == VK_TRUE;
+
         VkPhysicalDeviceFeatures deviceFeatures{};
+        deviceFeatures.pipelineStatisticsQuery = m_isPipelineStatsSupported ? VK_TRUE : VK_FALSE;
+        deviceFeatures.inheritedQueries        = m_isPipelineStatsSupported ? VK_TRUE : VK_FALSE;
+
+        VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures{};
+        dynamicRenderingFeatures.sType            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+        dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+
+        VkPhysicalDeviceVulkan12Features vulkan12Features{};
+        vulkan12Features.sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        vulkan12Features.pNext             = m_isDynamicRenderingSupported ? &dynamicRenderingFeatures : nullptr;
+        vulkan12Features.timelineSemaphore = VK_TRUE;
+
+        // below 1.3 dynamic rendering comes from the extension
+        std::vector<const char*> deviceExtensions = requiredExtensions;
+        if (m_isDynamicRenderingSupported && m_physicalDeviceProperties.apiVersion < VK_API_VERSION_1_3) {
+            deviceExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        }
 
         VkDeviceCreateInfo createInfo{};
         createInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext                   = &vulkan12Features;
         createInfo.queueCreateInfoCount    = static_cast<uint32_t>(queueCreateInfos.size());
         createInfo.pQueueCreateInfos       = queueCreateInfos.data();
         createInfo.enabledLayerCount       = static_cast<uint32_t>(layers.size());
         createInfo.ppEnabledLayerNames     = layers.data();
-        createInfo.enabledExtensionCount   = static_cast<uint32_t>(requiredExtensions.size());
-        createInfo.ppEnabledExtensionNames = requiredExtensions.data();
+        createInfo.enabledExtensionCount   = static_cast<uint32_t>(deviceExtensions.size());
+        createInfo.ppEnabledExtensionNames = deviceExtensions.data();
         createInfo.pEnabledFeatures        = &deviceFeatures;
 
-        OZ_VK_ASSERT(vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device));
+        OZ_VK_ASSERT(vkCreateDevice(m_physicalDevice, &createInfo, m_vkAllocator, &m_device));
     }
 
     // get device queues
     vkGetDeviceQueue(m_device, m_graphicsFamily, 0, &m_graphicsQueue);
+    for (AsyncQueue& queue : m_asyncQueues) {
+        if (queue.family != VK_QUEUE_FAMILY_IGNORED) {
+            vkGetDeviceQueue(m_device, queue.family, queue.queueIndex, &queue.vkQueue);
+        }
+    }
+
+    // load dynamic rendering commands, the core and extension entry points share their signatures
+    if (m_isDynamicRenderingSupported) {
+        const bool isCore     = m_physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_3;
+        m_vkCmdBeginRendering = (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(m_device, isCore ? "vkCmdBeginRendering" : "vkCmdBeginRenderingKHR");
+        m_vkCmdEndRendering   = (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(m_device, isCore ? "vkCmdEndRendering" : "vkCmdEndRenderingKHR");
+        m_isDynamicRenderingSupported = m_vkCmdBeginRendering != nullptr && m_vkCmdEndRendering != nullptr;
+    }
 
     // create a command pool
     {
@@ -226,26 +827,41 @@ GraphicsDevice::GraphicsDevice(const bool enableValidationLayers) {
         poolInfo.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
         poolInfo.queueFamilyIndex = m_graphicsFamily;
 
-        OZ_VK_ASSERT(vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool));
+        OZ_VK_ASSERT(vkCreateCommandPool(m_device, &poolInfo, m_vkAllocator, &m_commandPool));
+
+        for (AsyncQueue& queue : m_asyncQueues) {
+            if (queue.family != VK_QUEUE_FAMILY_IGNORED) {
+                poolInfo.queueFamilyIndex = queue.family;
+                OZ_VK_ASSERT(vkCreateCommandPool(m_device, &poolInfo, m_vkAllocator, &queue.vkCommandPool));
+            }
+        }
     }
 
     // create a descriptor pool
     {
         const uint32_t DESCRIPTOR_POOL_SIZE = 1024;
 
-        VkDescriptorPoolSize poolSize{};
-        poolSize.type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        poolSize.descriptorCount = DESCRIPTOR_POOL_SIZE;
+        VkDescriptorPoolSize poolSizes[3]{};
+        poolSizes[0].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        poolSizes[0].descriptorCount = DESCRIPTOR_POOL_SIZE;
+        poolSizes[1].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        poolSizes[1].descriptorCount = DESCRIPTOR_POOL_SIZE;
+        poolSizes[2].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSizes[2].descriptorCount = DESCRIPTOR_POOL_SIZE;
 
         VkDescriptorPoolCreateInfo poolInfo{};
         poolInfo.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.poolSizeCount = 1;
-        poolInfo.pPoolSizes    = &poolSize;
+        poolInfo.flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        poolInfo.poolSizeCount = 3;
+        poolInfo.pPoolSizes    = poolSizes;
         poolInfo.maxSets       = DESCRIPTOR_POOL_SIZE;
 
-        OZ_VK_ASSERT(vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool));
+        OZ_VK_ASSERT(vkCreateDescriptorPool(m_device, &poolInfo, m_vkAllocator, &m_descriptorPool));
     }
 
+    // create the pipeline cache
+    m_objects->pipelineCache.init(m_device, m_vkAllocator);
+
     // init current frame
     m_currentFrame = 0;
 
@@ -255,45 +871,130 @@ GraphicsDevice::GraphicsDevice(const bool enableValidationLayers) {
 
     // create synchronization objects
     for (size_t i = 0; i < FRAMES_IN_FLIGHT; i++) {
-        m_imageAvailableSemaphores.push_back(createSemaphore());
-        m_renderFinishedSemaphores.push_back(createSemaphore());
         m_inFlightFences.push_back(createFence());
     }
+    m_submitTimeline = createTimeline();
+    for (AsyncQueue& queue : m_asyncQueues) {
+        if (queue.family != VK_QUEUE_FAMILY_IGNORED) {
+            queue.timeline = createTimeline();
+        }
+    }
+
+    // create the transient uniform ring
+    m_uniformRegionSize = UNIFORM_RING_REGION_SIZE;
+    m_uniformRing       = createBuffer(BufferType::Uniform, m_uniformRegionSize * FRAMES_IN_FLIGHT);
+    m_uniformOffset     = 0;
+    m_uniformRegionEnd  = m_uniformRegionSize;
+
+    // create the staging ring, uploads run on the transfer queue if there is one
+    m_stagingRing = createBuffer(BufferType::Staging, STAGING_CHUNK_SIZE * STAGING_CHUNK_COUNT);
+    m_stagingSlots.resize(STAGING_CHUNK_COUNT);
+    for (StagingSlot& slot : m_stagingSlots) {
+        slot.cmd = createCommandBuffer(QueueType::Transfer);
+    }
+    m_stagingSlotIndex = 0;
+
+    // create the timestamp queries of the frame command buffers
+    const uint32_t timestampValidBits = m_queueFamilies[m_graphicsFamily].timestampValidBits;
+    if (timestampValidBits > 0) {
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType      = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+        queryPoolInfo.queryCount = 2 * FRAMES_IN_FLIGHT;
+
+        OZ_VK_ASSERT(vkCreateQueryPool(m_device, &queryPoolInfo, m_vkAllocator, &m_timestampQueryPool));
+        m_timestampMask = timestampValidBits >= 64 ? ~uint64_t(0) : (uint64_t(1) << timestampValidBits) - 1;
+    }
+
+    // create the pipeline statistics queries of the frame command buffers, one query per frame in flight
+    if (m_isPipelineStatsSupported) {
+        VkQueryPoolCreateInfo queryPoolInfo{};
+        queryPoolInfo.sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        queryPoolInfo.queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        queryPoolInfo.queryCount         = FRAMES_IN_FLIGHT;
+        queryPoolInfo.pipelineStatistics = PIPELINE_STATISTICS;
+
+        OZ_VK_ASSERT(vkCreateQueryPool(m_device, &queryPoolInfo, m_vkAllocator, &m_pipelineStatsQueryPool));
+    }
+    m_isFrameQueryWritten.assign(FRAMES_IN_FLIGHT, false);
+
+    // start the capture, the objects created above are recreated by the replaying device itself
+    std::string capturePath       = capture.path;
+    uint32_t    captureFrameCount = capture.frameCount;
+    if (capturePath.empty()) {
+        if (const char* path = std::getenv("OZ_CAPTURE_PATH")) {
+            capturePath = path;
+        }
+        if (const char* frameCount = std::getenv("OZ_CAPTURE_FRAMES")) {
+            captureFrameCount = static_cast<uint32_t>(std::strtoul(frameCount, nullptr, 10));
+        }
+    }
+    if (!capturePath.empty()) {
+        m_capture                = std::make_unique<CaptureWriter>(capturePath, captureFrameCount);
+        m_capture->uniformOffset = m_uniformOffset;
+        m_capture->record(CaptureCommand::GetUniformRing, m_uniformRing);
+    }
 }
 
 GraphicsDevice::~GraphicsDevice() {
+    // an unfinished capture keeps the frames presented so far
+    m_capture.reset();
+
+    // release pending frees
+    waitIdle();
+    collectRetiredObjects(std::numeric_limits<uint64_t>::max());
+
+    // destroy the staging ring, its command buffers belong to the pools destroyed below
+    for (StagingSlot& slot : m_stagingSlots) {
+        destroy(slot.cmd);
+    }
+    m_stagingSlots.clear();
+    destroy(m_stagingRing);
+
     // destroy descriptor pool
-    vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    vkDestroyDescriptorPool(m_device, m_descriptorPool, m_vkAllocator);
 
     // destroy command pool
-    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    vkDestroyCommandPool(m_device, m_commandPool, m_vkAllocator);
     m_commandPool = VK_NULL_HANDLE;
+    for (AsyncQueue& queue : m_asyncQueues) {
+        if (queue.vkCommandPool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(m_device, queue.vkCommandPool, m_vkAllocator);
+            queue.vkCommandPool = VK_NULL_HANDLE;
+        }
+    }
 
     // destroy synchronization objects
     for (size_t i = 0; i < FRAMES_IN_FLIGHT; i++) {
-        free(m_renderFinishedSemaphores[i]);
-        free(m_imageAvailableSemaphores[i]);
-        free(m_inFlightFences[i]);
+        destroy(m_inFlightFences[i]);
     }
-    m_renderFinishedSemaphores.clear();
-    m_imageAvailableSemaphores.clear();
     m_inFlightFences.clear();
+    destroy(m_submitTimeline);
+    for (AsyncQueue& queue : m_asyncQueues) {
+        destroy(queue.timeline);
+    }
+    destroy(m_uniformRing);
+    vkDestroyQueryPool(m_device, m_timestampQueryPool, m_vkAllocator);
+    vkDestroyQueryPool(m_device, m_pipelineStatsQueryPool, m_vkAllocator);
+
+    // destroy pipeline cache, after the pending frees released their pipelines
+    m_objects->pipelineCache.free(m_device);
 
     // destroy device
-    vkDestroyDevice(m_device, nullptr);
+    vkDestroyDevice(m_device, m_vkAllocator);
     m_device = VK_NULL_HANDLE;
 
     // destroy debug messenger
     if (m_debugMessenger != VK_NULL_HANDLE) {
         auto func = (PFN_vkDestroyDebugUtilsMessengerEXT)vkGetInstanceProcAddr(m_instance, "vkDestroyDebugUtilsMessengerEXT");
         if (func != nullptr) {
-            func(m_instance, m_debugMessenger, nullptr);
+            func(m_instance, m_debugMessenger, m_vkAllocator);
         }
         m_debugMessenger = VK_NULL_HANDLE;
     }
 
     // destroy instance
-    vkDestroyInstance(m_instance, nullptr);
+    vkDestroyInstance(m_instance, m_vkAllocator);
     m_instance = VK_NULL_HANDLE;
 
     // destroy glfw
@@ -301,6 +1002,8 @@ GraphicsDevice::~GraphicsDevice() {
 }
 
 Window GraphicsDevice::createWindow(const uint32_t width, const uint32_t height, const char* name) {
+    OZ_CAPTURE_SCOPE();
+
     // create window
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
@@ -308,7 +1011,7 @@ Window GraphicsDevice::createWindow(const uint32_t width, const uint32_t height,
 
     // create surface
     VkSurfaceKHR vkSurface;
-    OZ_VK_ASSERT(glfwCreateWindowSurface(m_instance, vkWindow, nullptr, &vkSurface));
+    OZ_VK_ASSERT(glfwCreateWindowSurface(m_instance, vkWindow, m_vkAllocator, &vkSurface));
 
     // create swap chain
     VkSwapchainKHR           vkSwapChain;
@@ -445,7 +1148,7 @@ Window GraphicsDevice::createWindow(const uint32_t width, const uint32_t height,
                     createInfo.pQueueFamilyIndices   = nullptr; // optional
                 }
 
-                OZ_VK_ASSERT(vkCreateSwapchainKHR(m_device, &createInfo, nullptr, &vkSwapChain));
+                OZ_VK_ASSERT(vkCreateSwapchainKHR(m_device, &createInfo, m_vkAllocator, &vkSwapChain));
             }
         }
 
@@ -472,32 +1175,55 @@ Window GraphicsDevice::createWindow(const uint32_t width, const uint32_t height,
             createInfo.subresourceRange.baseArrayLayer = 0;
             createInfo.subresourceRange.layerCount     = 1;
 
-            OZ_VK_ASSERT(vkCreateImageView(m_device, &createInfo, nullptr, &vkSwapChainImageViews[i]));
+            OZ_VK_ASSERT(vkCreateImageView(m_device, &createInfo, m_vkAllocator, &vkSwapChainImageViews[i]));
         }
     }
 
-    // create window object
-    Window window                  = OZ_CREATE_VK_OBJECT(Window);
-    window->vkWindow               = vkWindow;
-    window->vkSurface              = vkSurface;
-    window->vkSwapChain            = vkSwapChain;
-    window->vkSwapChainExtent      = std::move(vkSwapChainExtent);
-    window->vkSwapChainImageFormat = vkSwapChainImageFormat;
-    window->vkSwapChainImages      = std::move(vkSwapChainImages);
-    window->vkSwapChainImageViews  = std::move(vkSwapChainImageViews);
-    window->vkPresentQueue         = vkPresentQueue;
-    window->vkInstance             = m_instance;
+    // create synchronization objects
+    std::vector<VkSemaphore> vkImageAvailableSemaphores(FRAMES_IN_FLIGHT);
+    std::vector<VkSemaphore> vkRenderFinishedSemaphores(FRAMES_IN_FLIGHT);
+    {
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        for (size_t i = 0; i < FRAMES_IN_FLIGHT; i++) {
+            OZ_VK_ASSERT(vkCreateSemaphore(m_device, &semaphoreInfo, m_vkAllocator, &vkImageAvailableSemaphores[i]));
+            OZ_VK_ASSERT(vkCreateSemaphore(m_device, &semaphoreInfo, m_vkAllocator, &vkRenderFinishedSemaphores[i]));
+        }
+    }
 
+    // create window object
+    Window        window                    = OZ_CREATE_VK_OBJECT(Window);
+    WindowObject& windowObject              = get(window);
+    windowObject.vkWindow                   = vkWindow;
+    windowObject.vkSurface                  = vkSurface;
+    windowObject.vkSwapChain                = vkSwapChain;
+    windowObject.vkSwapChainExtent          = std::move(vkSwapChainExtent);
+    windowObject.vkSwapChainImageFormat     = vkSwapChainImageFormat;
+    windowObject.vkSwapChainImages          = std::move(vkSwapChainImages);
+    windowObject.vkSwapChainImageViews      = std::move(vkSwapChainImageViews);
+    windowObject.vkPresentQueue             = vkPresentQueue;
+    windowObject.vkImageAvailableSemaphores = std::move(vkImageAvailableSemaphores);
+    windowObject.vkRenderFinishedSemaphores = std::move(vkRenderFinishedSemaphores);
+    windowObject.vkInstance                 = m_instance;
+
+    OZ_CAPTURE(CreateWindow, width, height, std::string(name), window);
     return window;
 }
 
-CommandBuffer GraphicsDevice::createCommandBuffer() {
+CommandBuffer GraphicsDevice::createCommandBuffer(QueueType queueType) {
+    OZ_CAPTURE_SCOPE();
+
+    // queue types without a dedicated queue use the graphics queue
+    AsyncQueue*   asyncQueue    = getAsyncQueue(queueType);
+    VkCommandPool vkCommandPool = asyncQueue != nullptr ? asyncQueue->vkCommandPool : m_commandPool;
+
     // allocate command buffer
     VkCommandBuffer vkCommandBuffer;
     {
         VkCommandBufferAllocateInfo allocInfo{};
         allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool        = m_commandPool;
+        allocInfo.commandPool        = vkCommandPool;
         allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
         allocInfo.commandBufferCount = 1;
 
@@ -505,15 +1231,51 @@ CommandBuffer GraphicsDevice::createCommandBuffer() {
     }
 
     // create command buffer object
-    CommandBuffer commandBuffer    = OZ_CREATE_VK_OBJECT(CommandBuffer);
-    commandBuffer->vkCommandBuffer = vkCommandBuffer;
+    CommandBuffer        commandBuffer       = OZ_CREATE_VK_OBJECT(CommandBuffer);
+    CommandBufferObject& commandBufferObject = get(commandBuffer);
+    commandBufferObject.vkCommandBuffer      = vkCommandBuffer;
+    commandBufferObject.vkCommandPool        = vkCommandPool;
+    commandBufferObject.queueType            = asyncQueue != nullptr ? queueType : QueueType::Graphics;
+
+    OZ_CAPTURE(CreateCommandBuffer, queueType, commandBuffer);
     return commandBuffer;
 }
 
-Shader GraphicsDevice::createShader(const std::string& path, ShaderStage stage) {
+CommandBuffer GraphicsDevice::createCommandBundle() {
+    OZ_CAPTURE_SCOPE();
+
+    // allocate command buffer
+    VkCommandBuffer vkCommandBuffer;
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool        = m_commandPool;
+        allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        OZ_VK_ASSERT(vkAllocateCommandBuffers(m_device, &allocInfo, &vkCommandBuffer));
+    }
+
+    // create command buffer object
+    CommandBuffer        commandBuffer       = OZ_CREATE_VK_OBJECT(CommandBuffer);
+    CommandBufferObject& commandBufferObject = get(commandBuffer);
+    commandBufferObject.vkCommandBuffer      = vkCommandBuffer;
+    commandBufferObject.vkCommandPool        = m_commandPool;
+    commandBufferObject.isBundle             = true;
+
+    OZ_CAPTURE(CreateCommandBundle, commandBuffer);
+    return commandBuffer;
+}
+
+Shader GraphicsDevice::createShader(const std::string& path, ShaderStage stage, const SpecializationConstants& specialization) {
     std::string absolutePath = file::getBuildPath() + "/oz/resources/shaders/";
     absolutePath += path + ".spv";
-    auto code = file::readFile(absolutePath);
+
+    return createShader(file::readFile(absolutePath), stage, specialization);
+}
+
+Shader GraphicsDevice::createShader(const std::vector<char>& code, ShaderStage stage, const SpecializationConstants& specialization) {
+    OZ_CAPTURE_SCOPE();
 
     // create shader module
     VkShaderModule shaderModule;
@@ -523,7 +1285,7 @@ Shader GraphicsDevice::createShader(const std::string& path, ShaderStage stage)
         createInfo.codeSize = code.size();
         createInfo.pCode    = reinterpret_cast<const uint32_t*>(code.data());
 
-        OZ_VK_ASSERT(vkCreateShaderModule(m_device, &createInfo, nullptr, &shaderModule));
+        OZ_VK_ASSERT(vkCreateShaderModule(m_device, &createInfo, m_vkAllocator, &shaderModule));
     }
 
     VkPipelineShaderStageCreateInfo shaderStageInfo{};
@@ -533,24 +1295,34 @@ Shader GraphicsDevice::createShader(const std::string& path, ShaderStage stage)
     shaderStageInfo.pName  = "main";
 
     // create shader object
-    Shader shaderData                           = OZ_CREATE_VK_OBJECT(Shader);
-    shaderData->stage                           = stage;
-    shaderData->vkShaderModule                  = shaderModule;
-    shaderData->vkPipelineShaderStageCreateInfo = shaderStageInfo;
-
-    return shaderData;
+    Shader        shader                         = OZ_CREATE_VK_OBJECT(Shader);
+    ShaderObject& shaderObject                   = get(shader);
+    shaderObject.stage                           = stage;
+    shaderObject.vkShaderModule                  = shaderModule;
+    shaderObject.vkPipelineShaderStageCreateInfo = shaderStageInfo;
+    shaderObject.specialization                  = specialization;
+    shaderObject.codeHash                        = file::hash(code.data(), code.size());
+
+    // the code is embedded, replays do not depend on the shader files
+    OZ_CAPTURE(CreateShader, CaptureBlob{code.data(), code.size()}, stage, specialization, shader);
+    return shader;
 }
 
 RenderPass GraphicsDevice::createRenderPass(Shader                                  vertexShader,
                                             Shader                                  fragmentShader,
                                             Window                                  window,
                                             const VertexLayoutInfo&                 vertexLayout,
-                                            const std::vector<DescriptorSetLayout>& descriptorSetLayouts) {
+                                            const std::vector<DescriptorSetLayout>& descriptorSetLayouts,
+                                            const SpecializationConstants&          specialization) {
+    OZ_CAPTURE_SCOPE();
+
+    const WindowObject& windowObject = get(window);
+
     // create render pass
     VkRenderPass vkRenderPass;
     {
         VkAttachmentDescription colorAttachment{};
-        colorAttachment.format         = window->vkSwapChainImageFormat;
+        colorAttachment.format         = windowObject.vkSwapChainImageFormat;
         colorAttachment.samples        = VK_SAMPLE_COUNT_1_BIT;
         colorAttachment.loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR;
         colorAttachment.storeOp        = VK_ATTACHMENT_STORE_OP_STORE;
@@ -585,203 +1357,203 @@ RenderPass GraphicsDevice::createRenderPass(Shader
         renderPassInfo.dependencyCount = 1;
         renderPassInfo.pDependencies   = &dependency;
 
-        OZ_VK_ASSERT(vkCreateRenderPass(m_device, &renderPassInfo, nullptr, &vkRenderPass));
+        OZ_VK_ASSERT(vkCreateRenderPass(m_device, &renderPassInfo, m_vkAllocator, &vkRenderPass));
     }
 
     // create pipeline layout
-    VkPipelineLayout                   vkPipelineLayout;
-    std::vector<VkDescriptorSetLayout> vkDescriptorSetLayouts;
+    VkPipelineLayout                                                               vkPipelineLayout;
+    memory::InlineVector<VkDescriptorSetLayout, MAX_BOUND_DESCRIPTOR_SETS>            vkDescriptorSetLayouts;
+    memory::InlineVector<const DescriptorSetLayoutObject*, MAX_BOUND_DESCRIPTOR_SETS> descriptorSetLayoutObjects;
     for (const auto& layout : descriptorSetLayouts) {
-        vkDescriptorSetLayouts.push_back(layout->vkDescriptorSetLayout);
+        vkDescriptorSetLayouts.push_back(get(layout).vkDescriptorSetLayout);
+        descriptorSetLayoutObjects.push_back(&get(layout));
     }
 
-    {
-        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount         = vkDescriptorSetLayouts.size();
-        pipelineLayoutInfo.pSetLayouts            = vkDescriptorSetLayouts.data();
-        pipelineLayoutInfo.pushConstantRangeCount = 0;
-        pipelineLayoutInfo.pPushConstantRanges    = nullptr;
-
-        OZ_VK_ASSERT(vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &vkPipelineLayout));
+    vkPipelineLayout = createVkPipelineLayout(m_device, m_vkAllocator, vkDescriptorSetLayouts);
+
+    // create graphics pipeline, shared with the render passes of the same state and formats
+    PipelineStages        stages(get(vertexShader), get(fragmentShader), specialization);
+    std::vector<VkFormat> vkColorFormats = {windowObject.vkSwapChainImageFormat};
+    uint64_t              pipelineKey    = getPipelineKey(stages, vertexLayout, descriptorSetLayoutObjects, vkColorFormats, false);
+    PipelineCache&        pipelineCache  = m_objects->pipelineCache;
+
+    VkPipeline vkGraphicsPipeline = pipelineCache.acquire(pipelineKey);
+    if (vkGraphicsPipeline == VK_NULL_HANDLE) {
+        vkGraphicsPipeline = createVkGraphicsPipeline(m_device,
+                                                      m_vkAllocator,
+                                                      pipelineCache.getVkPipelineCache(),
+                                                      stages.vkStages.data(),
+                                                      vertexLayout,
+                                                      vkPipelineLayout,
+                                                      vkRenderPass,
+                                                      windowObject.vkSwapChainExtent,
+                                                      nullptr);
+        pipelineCache.insert(pipelineKey, vkGraphicsPipeline);
     }
 
-    // create vertex state input info
-    // TODO: store at the VertexLayout struct instead of re-creating for each render pass
-    VkPipelineVertexInputStateCreateInfo           vertexInputInfo{.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
-    VkVertexInputBindingDescription                bindingDescription{};
-    std::vector<VkVertexInputAttributeDescription> attributeDescriptions(vertexLayout.vertexLayoutAttributes.size());
-    {
-        if (vertexLayout.vertexLayoutAttributes.size() == 0) {
-            vertexInputInfo.vertexBindingDescriptionCount   = 0;
-            vertexInputInfo.vertexAttributeDescriptionCount = 0;
-            vertexInputInfo.pVertexBindingDescriptions      = nullptr;
-            vertexInputInfo.pVertexAttributeDescriptions    = nullptr;
-        } else {
-            for (int i = 0; i < vertexLayout.vertexLayoutAttributes.size(); i++) {
-                auto& vkAttributeDescription = attributeDescriptions[i];
-                auto& attribute              = vertexLayout.vertexLayoutAttributes[i];
-
-                vkAttributeDescription.binding  = 0;
-                vkAttributeDescription.location = i;
-                vkAttributeDescription.format   = (VkFormat)attribute.format; // TODO: do not cast, use conversion util
-                vkAttributeDescription.offset   = attribute.offset;
-            }
-            bindingDescription.binding   = 0;
-            bindingDescription.stride    = vertexLayout.vertexSize;
-            bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    // create frame buffers
+    std::vector<VkFramebuffer> vkFrameBuffers(windowObject.vkSwapChainImageViews.size());
+    for (size_t i = 0; i < windowObject.vkSwapChainImageViews.size(); i++) {
+        VkFramebufferCreateInfo framebufferInfo{};
+        framebufferInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass      = vkRenderPass;
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments    = &windowObject.vkSwapChainImageViews[i];
+        framebufferInfo.width           = windowObject.vkSwapChainExtent.width;
+        framebufferInfo.height          = windowObject.vkSwapChainExtent.height;
+        framebufferInfo.layers          = 1;
 
-            vertexInputInfo.vertexBindingDescriptionCount   = 1;
-            vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-            vertexInputInfo.pVertexBindingDescriptions      = &bindingDescription;
-            vertexInputInfo.pVertexAttributeDescriptions    = attributeDescriptions.data();
-        }
+        OZ_VK_ASSERT(vkCreateFramebuffer(m_device, &framebufferInfo, m_vkAllocator, &vkFrameBuffers[i]));
     }
 
-    // create graphics pipeline
-    VkPipeline vkGraphicsPipeline;
-    {
-        std::vector<VkDynamicState> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
-
-        VkPipelineDynamicStateCreateInfo dynamicState{};
-        dynamicState.sType             = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-        dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-        dynamicState.pDynamicStates    = dynamicStates.data();
-
-        VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-        inputAssembly.sType                  = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-        inputAssembly.topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-        VkViewport viewport{};
-        viewport.x        = 0.0f;
-        viewport.y        = 0.0f;
-        viewport.width    = static_cast<float>(window->vkSwapChainExtent.width);
-        viewport.height   = static_cast<float>(window->vkSwapChainExtent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-
-        VkRect2D scissor{};
-        scissor.offset = {0, 0};
-        scissor.extent = window->vkSwapChainExtent;
-
-        VkPipelineViewportStateCreateInfo viewportState{};
-        viewportState.sType         = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-        viewportState.viewportCount = 1;
-        viewportState.pViewports    = &viewport;
-        viewportState.scissorCount  = 1;
-        viewportState.pScissors     = &scissor;
-
-        VkPipelineRasterizationStateCreateInfo rasterizer{};
-        rasterizer.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-        rasterizer.depthClampEnable        = VK_FALSE;
-        rasterizer.rasterizerDiscardEnable = VK_FALSE;
-        rasterizer.polygonMode             = VK_POLYGON_MODE_FILL;
-        rasterizer.lineWidth               = 1.0f;
-        rasterizer.cullMode                = VK_CULL_MODE_BACK_BIT;
-        rasterizer.frontFace               = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-        rasterizer.depthBiasEnable = VK_FALSE;
+    // create render pass object
+    RenderPass        renderPass        = OZ_CREATE_VK_OBJECT(RenderPass);
+    RenderPassObject& renderPassObject  = get(renderPass);
+    renderPassObject.vkRenderPass       = vkRenderPass;
+    renderPassObject.vkPipelineLayout   = vkPipelineLayout;
+    renderPassObject.vkGraphicsPipeline = vkGraphicsPipeline;
+    renderPassObject.vkExtent           = windowObject.vkSwapChainExtent;
+    renderPassObject.vkFrameBuffers     = std::move(vkFrameBuffers);
+    renderPassObject.pipelineKey        = pipelineKey;
+    renderPassObject.pipelineCache      = &pipelineCache;
+
+    OZ_CAPTURE(CreateRenderPass, vertexShader, fragmentShader, window, vertexLayout, descriptorSetLayouts, specialization, renderPass);
+    return renderPass;
+}
 
-        VkPipelineMultisampleStateCreateInfo multisampling{};
-        multisampling.sType                = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-        multisampling.sampleShadingEnable  = VK_FALSE;
-        multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+RenderPass GraphicsDevice::createDynamicRenderPass(Shader                                  vertexShader,
+                                                   Shader                                  fragmentShader,
+                                                   Window                                  window,
+                                                   const VertexLayoutInfo&                 vertexLayout,
+                                                   const std::vector<DescriptorSetLayout>& descriptorSetLayouts,
+                                                   const SpecializationConstants&          specialization) {
+    OZ_CAPTURE_SCOPE();
 
-        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-        colorBlendAttachment.colorWriteMask =
-            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachment.blendEnable         = VK_FALSE;
-        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;  // Optional
-        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-        colorBlendAttachment.colorBlendOp        = VK_BLEND_OP_ADD;      // Optional
-        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;  // Optional
-        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-        colorBlendAttachment.alphaBlendOp        = VK_BLEND_OP_ADD;      // Optional
+    if (!m_isDynamicRenderingSupported) {
+        throw std::runtime_error("Dynamic rendering is not supported by the device!");
+    }
 
-        VkPipelineColorBlendStateCreateInfo colorBlending{};
-        colorBlending.sType             = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-        colorBlending.logicOpEnable     = VK_FALSE;
-        colorBlending.logicOp           = VK_LOGIC_OP_COPY; // Optional
-        colorBlending.attachmentCount   = 1;
-        colorBlending.pAttachments      = &colorBlendAttachment;
-        colorBlending.blendConstants[0] = 0.0f; // Optional
-        colorBlending.blendConstants[1] = 0.0f; // Optional
-        colorBlending.blendConstants[2] = 0.0f; // Optional
-        colorBlending.blendConstants[3] = 0.0f; // Optional
+    const WindowObject& windowObject = get(window);
 
-        VkGraphicsPipelineCreateInfo pipelineInfo{};
-        pipelineInfo.sType      = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-        pipelineInfo.stageCount = 2;
+    // create pipeline layout
+    memory::InlineVector<VkDescriptorSetLayout, MAX_BOUND_DESCRIPTOR_SETS>            vkDescriptorSetLayouts;
+    memory::InlineVector<const DescriptorSetLayoutObject*, MAX_BOUND_DESCRIPTOR_SETS> descriptorSetLayoutObjects;
+    for (const auto& layout : descriptorSetLayouts) {
+        vkDescriptorSetLayouts.push_back(get(layout).vkDescriptorSetLayout);
+        descriptorSetLayoutObjects.push_back(&get(layout));
+    }
+    VkPipelineLayout vkPipelineLayout = createVkPipelineLayout(m_device, m_vkAllocator, vkDescriptorSetLayouts);
+
+    // create graphics pipeline, only the attachment formats are fixed
+    std::vector<VkFormat> vkColorFormats = {windowObject.vkSwapChainImageFormat};
+
+    VkPipelineRenderingCreateInfo renderingInfo{};
+    renderingInfo.sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount    = static_cast<uint32_t>(vkColorFormats.size());
+    renderingInfo.pColorAttachmentFormats = vkColorFormats.data();
+    renderingInfo.depthAttachmentFormat   = VK_FORMAT_UNDEFINED;
+    renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+    PipelineStages stages(get(vertexShader), get(fragmentShader), specialization);
+    uint64_t       pipelineKey   = getPipelineKey(stages, vertexLayout, descriptorSetLayoutObjects, vkColorFormats, true);
+    PipelineCache& pipelineCache = m_objects->pipelineCache;
+
+    VkPipeline vkGraphicsPipeline = pipelineCache.acquire(pipelineKey);
+    if (vkGraphicsPipeline == VK_NULL_HANDLE) {
+        vkGraphicsPipeline = createVkGraphicsPipeline(m_device,
+                                                      m_vkAllocator,
+                                                      pipelineCache.getVkPipelineCache(),
+                                                      stages.vkStages.data(),
+                                                      vertexLayout,
+                                                      vkPipelineLayout,
+                                                      VK_NULL_HANDLE,
+                                                      windowObject.vkSwapChainExtent,
+                                                      &renderingInfo);
+        pipelineCache.insert(pipelineKey, vkGraphicsPipeline);
+    }
 
-        VkPipelineShaderStageCreateInfo stages[]= {vertexShader->vkPipelineShaderStageCreateInfo, fragmentShader->vkPipelineShaderStageCreateInfo};
-        pipelineInfo.pStages =stages;
-        pipelineInfo.pVertexInputState   = &vertexInputInfo;
-        pipelineInfo.pInputAssemblyState = &inputAssembly;
-        pipelineInfo.pViewportState      = &viewportState;
-        pipelineInfo.pRasterizationState = &rasterizer;
-        pipelineInfo.pMultisampleState   = &multisampling;
-        pipelineInfo.pColorBlendState    = &colorBlending;
-        pipelineInfo.pDynamicState       = &dynamicState;
-        pipelineInfo.layout              = vkPipelineLayout;
-        pipelineInfo.renderPass          = vkRenderPass;
-        pipelineInfo.subpass             = 0;
+    // create render pass object without render pass and frame buffers
+    RenderPass        renderPass        = OZ_CREATE_VK_OBJECT(RenderPass);
+    RenderPassObject& renderPassObject  = get(renderPass);
+    renderPassObject.vkPipelineLayout   = vkPipelineLayout;
+    renderPassObject.vkGraphicsPipeline = vkGraphicsPipeline;
+    renderPassObject.vkExtent           = windowObject.vkSwapChainExtent;
+    renderPassObject.vkColorFormats     = std::move(vkColorFormats);
+    renderPassObject.pipelineKey        = pipelineKey;
+    renderPassObject.pipelineCache      = &pipelineCache;
+
+    OZ_CAPTURE(CreateDynamicRenderPass, vertexShader, fragmentShader, window, vertexLayout, descriptorSetLayouts, specialization, renderPass);
+    return renderPass;
+}
 
-        OZ_VK_ASSERT(vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &vkGraphicsPipeline));
-    }
+Semaphore GraphicsDevice::createSemaphore() {
+    OZ_CAPTURE_SCOPE();
 
-    // create frame buffers
-    std::vector<VkFramebuffer> vkFrameBuffers(window->vkSwapChainImageViews.size());
-    for (size_t i = 0; i < window->vkSwapChainImageViews.size(); i++) {
-        VkFramebufferCreateInfo framebufferInfo{};
-        framebufferInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass      = vkRenderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments    = &window->vkSwapChainImageViews[i];
-        framebufferInfo.width           = window->vkSwapChainExtent.width;
-        framebufferInfo.height          = window->vkSwapChainExtent.height;
-        framebufferInfo.layers          = 1;
+    // create semaphore
+    VkSemaphore vkSemaphore;
+    {
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        OZ_VK_ASSERT(vkCreateFramebuffer(m_device, &framebufferInfo, nullptr, &vkFrameBuffers[i]));
+        OZ_VK_ASSERT(vkCreateSemaphore(m_device, &semaphoreInfo, m_vkAllocator, &vkSemaphore));
     }
 
-    // create render pass object
-    RenderPass renderPass          = OZ_CREATE_VK_OBJECT(RenderPass);
-    renderPass->vkRenderPass       = vkRenderPass;
-    renderPass->vkPipelineLayout   = vkPipelineLayout;
-    renderPass->vkGraphicsPipeline = vkGraphicsPipeline;
-    renderPass->vkExtent           = window->vkSwapChainExtent;
-    renderPass->vkFrameBuffers     = std::move(vkFrameBuffers);
+    // create semaphore object
+    Semaphore semaphore        = OZ_CREATE_VK_OBJECT(Semaphore);
+    get(semaphore).vkSemaphore = vkSemaphore;
 
-    return renderPass;
+    OZ_CAPTURE(CreateSemaphore, semaphore);
+    return semaphore;
 }
 
-Semaphore GraphicsDevice::createSemaphore() {
-    // create semaphore
+Timeline GraphicsDevice::createTimeline(uint64_t initialValue) {
+    OZ_CAPTURE_SCOPE();
+
+    // create timeline semaphore
     VkSemaphore vkSemaphore;
     {
+        VkSemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType         = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue  = initialValue;
+
         VkSemaphoreCreateInfo semaphoreInfo{};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphoreInfo.pNext = &typeInfo;
 
-        OZ_VK_ASSERT(vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &vkSemaphore));
+        OZ_VK_ASSERT(vkCreateSemaphore(m_device, &semaphoreInfo, m_vkAllocator, &vkSemaphore));
     }
 
-    // create semaphore object
-    Semaphore semaphore    = OZ_CREATE_VK_OBJECT(Semaphore);
-    semaphore->vkSemaphore = vkSemaphore;
+    // create timeline object
+    Timeline        timeline       = OZ_CREATE_VK_OBJECT(Timeline);
+    TimelineObject& timelineObject = get(timeline);
+    timelineObject.vkSemaphore     = vkSemaphore;
+    timelineObject.completedValue  = initialValue;
 
-    return semaphore;
+    OZ_CAPTURE(CreateTimeline, initialValue, timeline);
+    return timeline;
 }
 
 Buffer GraphicsDevice::createBuffer(BufferType bufferType, uint64_t size, const void* data) {
+    OZ_CAPTURE_SCOPE();
+
     // init buffer info and buffer flags
     bool                  persistent = false;
     VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    VkMemoryPropertyFlags preferred  = 0; // used if a memory type has them, otherwise properties alone
     VkBufferCreateInfo    bufferInfo{};
     bufferInfo.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     bufferInfo.size        = size;
     bufferInfo.usage       = 0;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    // buffers are used on every queue without ownership transfers
+    if (m_bufferQueueFamilies.size() > 1) {
+        bufferInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(m_bufferQueueFamilies.size());
+        bufferInfo.pQueueFamilyIndices   = m_bufferQueueFamilies.data();
+    }
+
     switch (bufferType) {
     case BufferType::Vertex:
         bufferInfo.usage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
@@ -792,12 +1564,26 @@ Buffer GraphicsDevice::createBuffer(BufferType bufferType, uint64_t size, const
     case BufferType::Staging:
         bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        persistent = data == nullptr; // written later through getBufferData
         break;
+    // host visible types are still valid copy and upload destinations
     case BufferType::Uniform:
-        bufferInfo.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+        bufferInfo.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        persistent = true;
+        break;
+    case BufferType::Storage:
+        bufferInfo.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
         properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
         persistent = true;
         break;
+    case BufferType::Readback:
+        // cached memory makes host reads fast, it might not be coherent
+        bufferInfo.usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        preferred  = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        persistent = true;
+        break;
     default:
         throw std::runtime_error("Not supported buffer type!");
         break;
@@ -805,10 +1591,11 @@ Buffer GraphicsDevice::createBuffer(BufferType bufferType, uint64_t size, const
 
     // create buffer
     VkBuffer vkBuffer;
-    OZ_VK_ASSERT(vkCreateBuffer(m_device, &bufferInfo, nullptr, &vkBuffer));
+    OZ_VK_ASSERT(vkCreateBuffer(m_device, &bufferInfo, m_vkAllocator, &vkBuffer));
 
     // find suitable memory and allocate
     VkDeviceMemory vkBufferMemory;
+    bool           isHostCoherent = true;
     {
         // get memory requirements
         VkMemoryRequirements memRequirements;
@@ -817,15 +1604,21 @@ Buffer GraphicsDevice::createBuffer(BufferType bufferType, uint64_t size, const
         VkPhysicalDeviceMemoryProperties memProperties;
         vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
 
-        uint32_t i = 0;
-        for (; i < memProperties.memoryTypeCount; i++) {
-            if ((memRequirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+        uint32_t i = memProperties.memoryTypeCount;
+        for (VkMemoryPropertyFlags flags : {properties | preferred, properties}) {
+            for (i = 0; i < memProperties.memoryTypeCount; i++) {
+                if ((memRequirements.memoryTypeBits & (1 << i)) && (memProperties.memoryTypes[i].propertyFlags & flags) == flags) {
+                    break;
+                }
+            }
+            if (i < memProperties.memoryTypeCount) {
                 break;
             }
         }
         if (i >= memProperties.memoryTypeCount) {
             throw std::runtime_error("Failed to find suitable memory type!");
         }
+        isHostCoherent = (memProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
 
         VkMemoryAllocateInfo allocInfo{};
         allocInfo.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -833,7 +1626,7 @@ Buffer GraphicsDevice::createBuffer(BufferType bufferType, uint64_t size, const
         allocInfo.memoryTypeIndex = i;
 
         // allocate memory //
-        OZ_VK_ASSERT(vkAllocateMemory(m_device, &allocInfo, nullptr, &vkBufferMemory));
+        OZ_VK_ASSERT(vkAllocateMemory(m_device, &allocInfo, m_vkAllocator, &vkBufferMemory));
     }
 
     // bind memory
@@ -854,22 +1647,30 @@ Buffer GraphicsDevice::createBuffer(BufferType bufferType, uint64_t size, const
     }
 
     // create buffer object
-    Buffer buffer    = OZ_CREATE_VK_OBJECT(Buffer);
-    buffer->vkBuffer = vkBuffer;
-    buffer->vkMemory = vkBufferMemory;
-    buffer->data     = pData;
-
+    Buffer        buffer        = OZ_CREATE_VK_OBJECT(Buffer);
+    BufferObject& bufferObject  = get(buffer);
+    bufferObject.vkBuffer       = vkBuffer;
+    bufferObject.vkMemory       = vkBufferMemory;
+    bufferObject.size           = size;
+    bufferObject.data           = pData;
+    bufferObject.isHostCoherent = isHostCoherent;
+
+    OZ_CAPTURE(CreateBuffer, bufferType, size, CaptureBlob{data, data != nullptr ? size : 0}, buffer);
     return buffer;
 }
 
 DescriptorSetLayout GraphicsDevice::createDescriptorSetLayout(const DescriptorSetLayoutInfo& setLayout) {
+    OZ_CAPTURE_SCOPE();
+
     // create descriptor set layout bindings
-    std::vector<VkDescriptorSetLayoutBinding> descriptorSetLayoutBindings(setLayout.bindings.size());
+    VkDescriptorSetLayoutBinding                                        descriptorSetLayoutBindings[MAX_DESCRIPTOR_SET_BINDINGS] = {};
+    memory::InlineVector<VkDescriptorType, MAX_DESCRIPTOR_SET_BINDINGS> vkDescriptorTypes;
     for (int bindingIdx = 0; bindingIdx < setLayout.bindings.size(); bindingIdx++) {
         const DescriptorSetLayoutBindingInfo& setLayoutBinding = setLayout.bindings[bindingIdx];
+        vkDescriptorTypes.push_back(getVkDescriptorType(setLayoutBinding.type));
 
         descriptorSetLayoutBindings[bindingIdx].binding            = bindingIdx;
-        descriptorSetLayoutBindings[bindingIdx].descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptorSetLayoutBindings[bindingIdx].descriptorType     = vkDescriptorTypes[bindingIdx];
         descriptorSetLayoutBindings[bindingIdx].descriptorCount    = 1;
         descriptorSetLayoutBindings[bindingIdx].stageFlags         = VK_SHADER_STAGE_VERTEX_BIT;
         descriptorSetLayoutBindings[bindingIdx].pImmutableSamplers = nullptr;
@@ -878,66 +1679,93 @@ DescriptorSetLayout GraphicsDevice::createDescriptorSetLayout(const DescriptorSe
     // create descriptor set layout
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = descriptorSetLayoutBindings.size();
-    layoutInfo.pBindings    = descriptorSetLayoutBindings.data();
+    layoutInfo.bindingCount = static_cast<uint32_t>(vkDescriptorTypes.size());
+    layoutInfo.pBindings    = descriptorSetLayoutBindings;
 
     VkDescriptorSetLayout vkDescriptorSetLayout;
-    OZ_VK_ASSERT(vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &vkDescriptorSetLayout));
+    OZ_VK_ASSERT(vkCreateDescriptorSetLayout(m_device, &layoutInfo, m_vkAllocator, &vkDescriptorSetLayout));
 
     // create descriptor set layout object
-    DescriptorSetLayout descriptorSetLayout    = OZ_CREATE_VK_OBJECT(DescriptorSetLayout);
-    descriptorSetLayout->vkDescriptorSetLayout = vkDescriptorSetLayout;
+    DescriptorSetLayout        descriptorSetLayout       = OZ_CREATE_VK_OBJECT(DescriptorSetLayout);
+    DescriptorSetLayoutObject& descriptorSetLayoutObject = get(descriptorSetLayout);
+    descriptorSetLayoutObject.vkDescriptorSetLayout      = vkDescriptorSetLayout;
+    descriptorSetLayoutObject.vkDescriptorTypes          = vkDescriptorTypes;
 
+    OZ_CAPTURE(CreateDescriptorSetLayout, setLayout, descriptorSetLayout);
     return descriptorSetLayout;
 }
 
 DescriptorSet GraphicsDevice::createDescriptorSet(DescriptorSetLayout descriptorSetLayout, const DescriptorSetInfo& descriptorSetInfo) {
+    OZ_CAPTURE_SCOPE();
+
+    const DescriptorSetLayoutObject& descriptorSetLayoutObject = get(descriptorSetLayout);
+    assert(descriptorSetInfo.bindings.size() <= descriptorSetLayoutObject.vkDescriptorTypes.size());
+
     // create descriptor set
     VkDescriptorSetAllocateInfo allocInfo{};
     {
         allocInfo.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocInfo.descriptorPool     = m_descriptorPool;
         allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts        = &descriptorSetLayout->vkDescriptorSetLayout;
+        allocInfo.pSetLayouts        = &descriptorSetLayoutObject.vkDescriptorSetLayout;
     }
 
     // allocate descriptor sets
     VkDescriptorSet vkDescriptorSet;
     OZ_VK_ASSERT(vkAllocateDescriptorSets(m_device, &allocInfo, &vkDescriptorSet));
 
-    // update descriptor sets
+    // update descriptor sets, all bindings with one call
+    VkDescriptorBufferInfo bufferInfos[MAX_DESCRIPTOR_SET_BINDINGS];
+    VkWriteDescriptorSet   descriptorWrites[MAX_DESCRIPTOR_SET_BINDINGS];
     for (int bindingIdx = 0; bindingIdx < descriptorSetInfo.bindings.size(); bindingIdx++) {
         const DescriptorSetBindingInfo& descriptorSetBinding = descriptorSetInfo.bindings[bindingIdx];
 
-        VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = descriptorSetBinding.bufferInfo.buffer->vkBuffer;
-        bufferInfo.offset = 0;
-        bufferInfo.range  = descriptorSetBinding.bufferInfo.range;
-
-        VkWriteDescriptorSet descriptorWrite{};
-        descriptorWrite.sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite.dstSet           = vkDescriptorSet;
-        descriptorWrite.dstBinding       = bindingIdx;
-        descriptorWrite.dstArrayElement  = 0;
-        descriptorWrite.descriptorType   = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrite.descriptorCount  = 1;
-        descriptorWrite.pBufferInfo      = &bufferInfo;
-        descriptorWrite.pImageInfo       = nullptr; // Optional
-        descriptorWrite.pTexelBufferView = nullptr; // Optional
-
-        vkUpdateDescriptorSets(m_device, 1, &descriptorWrite, 0, nullptr);
+        VkDescriptorBufferInfo& bufferInfo = bufferInfos[bindingIdx];
+        bufferInfo                         = {};
+        bufferInfo.buffer                  = get(descriptorSetBinding.bufferInfo.buffer).vkBuffer;
+        bufferInfo.offset                  = 0;
+        bufferInfo.range                   = descriptorSetBinding.bufferInfo.range;
+
+        VkWriteDescriptorSet& descriptorWrite = descriptorWrites[bindingIdx];
+        descriptorWrite                       = {};
+        descriptorWrite.sType                 = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrite.dstSet                = vkDescriptorSet;
+        descriptorWrite.dstBinding            = bindingIdx;
+        descriptorWrite.dstArrayElement       = 0;
+        descriptorWrite.descriptorType        = descriptorSetLayoutObject.vkDescriptorTypes[bindingIdx];
+        descriptorWrite.descriptorCount       = 1;
+        descriptorWrite.pBufferInfo           = &bufferInfo;
+        descriptorWrite.pImageInfo            = nullptr; // Optional
+        descriptorWrite.pTexelBufferView      = nullptr; // Optional
     }
+    vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(descriptorSetInfo.bindings.size()), descriptorWrites, 0, nullptr);
 
     // create descriptor set object
-    DescriptorSet descriptorSet    = OZ_CREATE_VK_OBJECT(DescriptorSet);
-    descriptorSet->vkDescriptorSet = vkDescriptorSet;
+    DescriptorSet        descriptorSet       = OZ_CREATE_VK_OBJECT(DescriptorSet);
+    DescriptorSetObject& descriptorSetObject = get(descriptorSet);
+    descriptorSetObject.vkDescriptorSet      = vkDescriptorSet;
+    descriptorSetObject.vkDescriptorPool     = m_descriptorPool;
 
+    OZ_CAPTURE(CreateDescriptorSet, descriptorSetLayout, descriptorSetInfo, descriptorSet);
     return descriptorSet;
 }
 
-void GraphicsDevice::waitIdle() const { vkDeviceWaitIdle(m_device); }
+void GraphicsDevice::waitIdle() const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(WaitIdle);
+
+    vkDeviceWaitIdle(m_device);
+
+    // nothing submitted is in flight anymore, objects freed during an open frame recording may still be recorded in it
+    if (!get(m_commandBuffers[m_currentFrame]).isSubmitPending) {
+        m_objects->deletionQueue.resolvePending(m_submitValue);
+    }
+    collectRetiredObjects(m_submitValue);
+}
 
 Fence GraphicsDevice::createFence() {
+    OZ_CAPTURE_SCOPE();
+
     // create fence
     VkFence vkFence;
     {
@@ -945,198 +1773,1075 @@ Fence GraphicsDevice::createFence() {
         fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
         fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-        OZ_VK_ASSERT(vkCreateFence(m_device, &fenceInfo, nullptr, &vkFence));
+        OZ_VK_ASSERT(vkCreateFence(m_device, &fenceInfo, m_vkAllocator, &vkFence));
     }
 
     // create fence object
-    Fence fence    = OZ_CREATE_VK_OBJECT(Fence);
-    fence->vkFence = vkFence;
+    Fence fence        = OZ_CREATE_VK_OBJECT(Fence);
+    get(fence).vkFence = vkFence;
 
+    OZ_CAPTURE(CreateFence, fence);
     return fence;
 }
 
 void GraphicsDevice::waitFences(Fence fence, uint32_t fenceCount, bool waitAll) const {
-    vkWaitForFences(m_device, fenceCount, &fence->vkFence, waitAll ? VK_TRUE : VK_FALSE, UINT64_MAX);
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(WaitFences, fence, fenceCount, waitAll);
+
+    vkWaitForFences(m_device, fenceCount, &get(fence).vkFence, waitAll ? VK_TRUE : VK_FALSE, UINT64_MAX);
 }
 
-void GraphicsDevice::resetFences(Fence fence, uint32_t fenceCount) const { vkResetFences(m_device, fenceCount, &fence->vkFence); }
+void GraphicsDevice::resetFences(Fence fence, uint32_t fenceCount) const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(ResetFences, fence, fenceCount);
 
-CommandBuffer GraphicsDevice::getCurrentCommandBuffer() const { return m_commandBuffers[m_currentFrame]; }
+    vkResetFences(m_device, fenceCount, &get(fence).vkFence);
+}
 
-uint32_t GraphicsDevice::getCurrentImage(Window window) const {
-    glfwPollEvents();
+bool GraphicsDevice::isComplete(Timeline timeline, uint64_t value) const {
+    // only query the counter if the cached value is not recent enough
+    const TimelineObject& timelineObject = get(timeline);
+    return timelineObject.completedValue >= value || getTimelineValue(timeline) >= value;
+}
 
+bool GraphicsDevice::isComplete(const TimelinePoint& point) const { return isComplete(point.timeline, point.value); }
+
+uint64_t GraphicsDevice::getTimelineValue(Timeline timeline) const {
+    // called outside of the assert, the counter has to be read in release builds too
+    TimelineObject&                 timelineObject = get(timeline);
+    [[maybe_unused]] const VkResult result         = vkGetSemaphoreCounterValue(m_device, timelineObject.vkSemaphore, &timelineObject.completedValue);
+    OZ_VK_ASSERT(result);
+
+    return timelineObject.completedValue;
+}
+
+void GraphicsDevice::waitTimeline(Timeline timeline, uint64_t value) const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(WaitTimeline, timeline, value);
+
+    if (isComplete(timeline, value)) {
+        return;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores    = &get(timeline).vkSemaphore;
+    waitInfo.pValues        = &value;
+
+    [[maybe_unused]] const VkResult result = vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX);
+    OZ_VK_ASSERT(result);
+    get(timeline).completedValue = value;
+}
+
+void GraphicsDevice::signalTimeline(Timeline timeline, uint64_t value) const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(SignalTimeline, timeline, value);
+
+    VkSemaphoreSignalInfo signalInfo{};
+    signalInfo.sType     = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+    signalInfo.semaphore = get(timeline).vkSemaphore;
+    signalInfo.value     = value;
+
+    [[maybe_unused]] const VkResult result = vkSignalSemaphore(m_device, &signalInfo);
+    OZ_VK_ASSERT(result);
+}
+
+CommandBuffer GraphicsDevice::getCurrentCommandBuffer() const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(GetCurrentCommandBuffer, m_commandBuffers[m_currentFrame]);
+    return m_commandBuffers[m_currentFrame];
+}
+
+void GraphicsDevice::paceFrame() {
+    assert(!m_isFrameBegun);
+    m_frameTiming.pacingSleepMs = m_framePacer.pace();
+}
+
+void GraphicsDevice::beginFrame() {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BeginFrame);
+
+    // the fence is reset on submit, so a frame that is never submitted does not block the next one
+    const auto waitStart = FramePacer::Clock::now();
     waitFences(m_inFlightFences[m_currentFrame], 1);
-    resetFences(m_inFlightFences[m_currentFrame], 1);
+    m_frameTiming.waitMs += std::chrono::duration<double, std::milli>(FramePacer::Clock::now() - waitStart).count();
+
+    // the last submission of the frame command buffer has completed with the fence
+    if (m_isFrameQueryWritten[m_currentFrame]) {
+        if (m_timestampQueryPool != VK_NULL_HANDLE) {
+            uint64_t timestamps[2];
+            if (vkGetQueryPoolResults(m_device,
+                                      m_timestampQueryPool,
+                                      2 * m_currentFrame,
+                                      2,
+                                      sizeof(timestamps),
+                                      timestamps,
+                                      sizeof(uint64_t),
+                                      VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+                const uint64_t ticks = (timestamps[1] - timestamps[0]) & m_timestampMask;
+                m_frameTiming.gpuMs  = ticks * double(m_physicalDeviceProperties.limits.timestampPeriod) / 1e6;
+            }
+        }
+        if (m_pipelineStatsQueryPool != VK_NULL_HANDLE) {
+            static_assert(sizeof(PipelineStats) == 6 * sizeof(uint64_t));
+            m_frameStats.isPipelineStatsValid = vkGetQueryPoolResults(m_device,
+                                                                      m_pipelineStatsQueryPool,
+                                                                      m_currentFrame,
+                                                                      1,
+                                                                      sizeof(PipelineStats),
+                                                                      &m_frameStats.pipeline,
+                                                                      sizeof(PipelineStats),
+                                                                      VK_QUERY_RESULT_64_BIT) == VK_SUCCESS;
+        }
+        m_isFrameQueryWritten[m_currentFrame] = false;
+    }
+
+    collectRetiredObjects(getCompletedSubmitValue());
+
+    // the frame in flight is done with its uniform region
+    m_uniformOffset    = m_currentFrame * m_uniformRegionSize;
+    m_uniformRegionEnd = m_uniformOffset + m_uniformRegionSize;
+    if (m_capture != nullptr) {
+        m_capture->uniformOffset = m_uniformOffset;
+    }
+
+    m_frameWindowCount = 0;
+    m_isFrameBegun     = true;
+}
+
+uint32_t GraphicsDevice::getCurrentImage(Window window) {
+    OZ_CAPTURE_SCOPE();
+
+    if (!m_isFrameBegun) {
+        beginFrame();
+    }
+
+    // a window is acquired once per frame
+    for (uint32_t i = 0; i < m_frameWindowCount; i++) {
+        if (m_frameWindows[i] == window) {
+            return m_frameImageIndices[i];
+        }
+    }
+
+    if (m_frameWindowCount == MAX_FRAME_WINDOWS) {
+        throw std::runtime_error("Too many windows acquired in one frame!");
+    }
+
+    const WindowObject& windowObject = get(window);
+
+    uint32_t   imageIndex;
+    const auto acquireStart = FramePacer::Clock::now();
+    const VkResult result = vkAcquireNextImageKHR(
+        m_device, windowObject.vkSwapChain, UINT64_MAX, windowObject.vkImageAvailableSemaphores[m_currentFrame], VK_NULL_HANDLE, &imageIndex);
+    const auto acquireEnd = FramePacer::Clock::now();
+    checkSwapChainResult(result);
+    m_frameTiming.waitMs += std::chrono::duration<double, std::milli>(acquireEnd - acquireStart).count();
+
+    // the frame is available once the first image is acquired
+    if (m_frameWindowCount == 0) {
+        m_framePacer.markReady(acquireEnd, m_frameTiming.waitMs);
+    }
 
-    uint32_t imageIndex;
-    vkAcquireNextImageKHR(m_device,
-                          window->vkSwapChain,
-                          UINT64_MAX,
-                          m_imageAvailableSemaphores[m_currentFrame]->vkSemaphore,
-                          VK_NULL_HANDLE,
-                          &imageIndex);
+    m_frameWindows[m_frameWindowCount]      = window;
+    m_frameImageIndices[m_frameWindowCount] = imageIndex;
+    m_frameWindowCount++;
 
+    OZ_CAPTURE(GetCurrentImage, window, imageIndex);
     return imageIndex;
 }
 
+bool GraphicsDevice::isDynamicRenderingSupported() const { return m_isDynamicRenderingSupported; }
+
+bool GraphicsDevice::hasDedicatedQueue(QueueType queueType) const {
+    switch (queueType) {
+    case QueueType::Compute:
+        return m_asyncQueues[ASYNC_COMPUTE].isDedicated;
+    case QueueType::Transfer:
+        return m_asyncQueues[ASYNC_TRANSFER].isDedicated;
+    default:
+        return true;
+    }
+}
+
 uint32_t GraphicsDevice::getCurrentFrame() const { return m_currentFrame; }
 
-bool GraphicsDevice::isWindowOpen(Window window) const { return !glfwWindowShouldClose(window->vkWindow); }
+UniformAllocation GraphicsDevice::allocateUniform(size_t size) {
+    // the region of the current frame is only free once the frame in flight has completed
+    if (!m_isFrameBegun) {
+        beginFrame();
+    }
+
+    const uint64_t alignment = std::max<uint64_t>(m_physicalDeviceProperties.limits.minUniformBufferOffsetAlignment, 1);
+    const uint64_t offset    = (m_uniformOffset + alignment - 1) / alignment * alignment;
+    if (offset + size > m_uniformRegionEnd) {
+        throw std::runtime_error("Uniform ring is exhausted!");
+    }
+    m_uniformOffset = offset + size;
+
+    UniformAllocation allocation;
+    allocation.data   = static_cast<char*>(get(m_uniformRing).data) + offset;
+    allocation.offset = static_cast<uint32_t>(offset);
+
+    return allocation;
+}
+
+Buffer GraphicsDevice::getUniformRing() const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(GetUniformRing, m_uniformRing);
+    return m_uniformRing;
+}
+
+void* GraphicsDevice::getBufferData(Buffer buffer) const {
+    // the application writes through the pointer, the capture stores the contents with every submission
+    if (m_capture != nullptr && m_capture->isRecording() && buffer != m_uniformRing) {
+        std::vector<Buffer>& mappedBuffers = m_capture->mappedBuffers;
+        if (std::find(mappedBuffers.begin(), mappedBuffers.end(), buffer) == mappedBuffers.end()) {
+            mappedBuffers.push_back(buffer);
+        }
+    }
+    return get(buffer).data;
+}
+
+const CommandStats& GraphicsDevice::getCommandStats(CommandBuffer cmd) const { return get(cmd).stats; }
+
+const FrameTimingStats& GraphicsDevice::getFrameTimingStats() const { return m_lastFrameTiming; }
+
+const FrameStats& GraphicsDevice::getFrameStats() const { return m_lastFrameStats; }
+
+HostMemoryStats GraphicsDevice::getHostMemoryStats() const { return m_hostAllocator != nullptr ? m_hostAllocator->getStats() : HostMemoryStats{}; }
+
+void GraphicsDevice::pollEvents() {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(PollEvents);
+
+    glfwPollEvents();
+    m_inputSampleTime = FramePacer::Clock::now();
+    m_isInputSampled  = true;
+}
+
+bool GraphicsDevice::isWindowOpen(Window window) const { return !glfwWindowShouldClose(get(window).vkWindow); }
+
+void GraphicsDevice::presentFrame() {
+    OZ_CAPTURE_SCOPE();
+
+    assert(m_isFrameBegun);
+
+    if (m_frameWindowCount > 0) {
+        VkSemaphore    waitSemaphores[MAX_FRAME_WINDOWS];
+        VkSwapchainKHR swapChains[MAX_FRAME_WINDOWS];
+        VkResult       results[MAX_FRAME_WINDOWS];
+
+        // every window is presented on the queue of the first one
+        VkQueue vkPresentQueue = get(m_frameWindows[0]).vkPresentQueue;
+        for (uint32_t i = 0; i < m_frameWindowCount; i++) {
+            const WindowObject& windowObject = get(m_frameWindows[i]);
+            assert(windowObject.vkPresentQueue == vkPresentQueue);
+
+            waitSemaphores[i] = windowObject.vkRenderFinishedSemaphores[m_currentFrame];
+            swapChains[i]     = windowObject.vkSwapChain;
+        }
 
-void GraphicsDevice::presentImage(Window window, uint32_t imageIndex) {
-    {
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores    = &m_renderFinishedSemaphores[m_currentFrame]->vkSemaphore;
-        presentInfo.swapchainCount     = 1;
-        presentInfo.pSwapchains        = &window->vkSwapChain;
-        presentInfo.pImageIndices      = &imageIndex;
-        presentInfo.pResults           = nullptr; // optional
-
-        OZ_VK_ASSERT(vkQueuePresentKHR(window->vkPresentQueue, &presentInfo));
+        presentInfo.waitSemaphoreCount = m_frameWindowCount;
+        presentInfo.pWaitSemaphores    = waitSemaphores;
+        presentInfo.swapchainCount     = m_frameWindowCount;
+        presentInfo.pSwapchains        = swapChains;
+        presentInfo.pImageIndices      = m_frameImageIndices.data();
+        presentInfo.pResults           = results;
+
+        vkQueuePresentKHR(vkPresentQueue, &presentInfo);
+        for (uint32_t i = 0; i < m_frameWindowCount; i++) {
+            checkSwapChainResult(results[i]);
+        }
     }
 
-    m_currentFrame = (m_currentFrame + 1) % FRAMES_IN_FLIGHT;
+    // frame timings
+    if (m_isInputSampled) {
+        m_frameTiming.inputToPresentMs = std::chrono::duration<double, std::milli>(FramePacer::Clock::now() - m_inputSampleTime).count();
+    }
+    m_frameTiming.framePeriodMs = m_framePacer.getPeriodMs();
+    m_lastFrameTiming           = m_frameTiming;
+    m_frameTiming               = {};
+    m_isInputSampled            = false;
+
+    // frame stats
+    m_lastFrameStats = m_frameStats;
+    m_frameStats     = {};
+
+    m_frameWindowCount = 0;
+    m_isFrameBegun     = false;
+    m_currentFrame     = (m_currentFrame + 1) % FRAMES_IN_FLIGHT;
+
+    // the capture is written frame by frame
+    if (captureScope.isRecorded()) {
+        m_capture->record(CaptureCommand::PresentFrame);
+        m_capture->endFrame();
+    }
 }
 
 void GraphicsDevice::beginCmd(CommandBuffer cmd, bool isSingleUse) const {
-    vkResetCommandBuffer(cmd->vkCommandBuffer, 0);
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BeginCmd, cmd, isSingleUse);
+
+    assert(!get(cmd).isBundle); // bundles are begun with beginBundle
+    vkResetCommandBuffer(get(cmd).vkCommandBuffer, 0);
+    get(cmd).resetBoundState();
+    get(cmd).readbacks.clear();
+    get(cmd).isSubmitPending = true;
+
+    // bundles executed by a recording that was never submitted are no longer referenced
+    for (CommandBuffer bundle : get(cmd).executedBundles) {
+        get(bundle).pendingExecutions--;
+    }
+    get(cmd).executedBundles.clear();
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags            = isSingleUse ? VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT : 0;
     beginInfo.pInheritanceInfo = nullptr; // optional
 
-    OZ_VK_ASSERT(vkBeginCommandBuffer(cmd->vkCommandBuffer, &beginInfo));
+    OZ_VK_ASSERT(vkBeginCommandBuffer(get(cmd).vkCommandBuffer, &beginInfo));
+
+    // the frame command buffer is timed and counted, the results are read once the frame is available again
+    if (cmd == m_commandBuffers[m_currentFrame]) {
+        if (m_timestampQueryPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(get(cmd).vkCommandBuffer, m_timestampQueryPool, 2 * m_currentFrame, 2);
+            vkCmdWriteTimestamp(get(cmd).vkCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampQueryPool, 2 * m_currentFrame);
+        }
+        if (m_pipelineStatsQueryPool != VK_NULL_HANDLE) {
+            vkCmdResetQueryPool(get(cmd).vkCommandBuffer, m_pipelineStatsQueryPool, m_currentFrame, 1);
+            vkCmdBeginQuery(get(cmd).vkCommandBuffer, m_pipelineStatsQueryPool, m_currentFrame, 0);
+        }
+    }
+}
+
+void GraphicsDevice::endCmd(CommandBuffer cmd) const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(EndCmd, cmd);
+
+    if (cmd == m_commandBuffers[m_currentFrame]) {
+        if (m_pipelineStatsQueryPool != VK_NULL_HANDLE) {
+            vkCmdEndQuery(get(cmd).vkCommandBuffer, m_pipelineStatsQueryPool, m_currentFrame);
+        }
+        if (m_timestampQueryPool != VK_NULL_HANDLE) {
+            vkCmdWriteTimestamp(get(cmd).vkCommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampQueryPool, 2 * m_currentFrame + 1);
+        }
+    }
+    OZ_VK_ASSERT(vkEndCommandBuffer(get(cmd).vkCommandBuffer));
+}
+
+TimelinePoint GraphicsDevice::submitCmd(CommandBuffer cmd, std::initializer_list<TimelinePoint> waits, std::initializer_list<TimelinePoint> signals) {
+    return submitCmd(
+        cmd, std::span<const TimelinePoint>(waits.begin(), waits.size()), std::span<const TimelinePoint>(signals.begin(), signals.size()));
 }
 
-void GraphicsDevice::endCmd(CommandBuffer cmd) const { OZ_VK_ASSERT(vkEndCommandBuffer(cmd->vkCommandBuffer)); }
+TimelinePoint GraphicsDevice::submitCmd(CommandBuffer cmd, std::span<const TimelinePoint> waits, std::span<const TimelinePoint> signals) {
+    static constexpr uint32_t MAX_SUBMIT_SEMAPHORES = 16 + MAX_FRAME_WINDOWS;
+    OZ_CAPTURE_SCOPE();
+
+    if (captureScope.isRecorded()) {
+        captureMappedData();
+    }
+
+    assert(waits.size() + MAX_FRAME_WINDOWS + 2 <= MAX_SUBMIT_SEMAPHORES && signals.size() + MAX_FRAME_WINDOWS + 1 <= MAX_SUBMIT_SEMAPHORES);
+
+    VkSemaphore          waitSemaphores[MAX_SUBMIT_SEMAPHORES];
+    uint64_t             waitValues[MAX_SUBMIT_SEMAPHORES];
+    VkPipelineStageFlags waitStages[MAX_SUBMIT_SEMAPHORES];
+    uint32_t             waitCount = 0;
+
+    VkSemaphore signalSemaphores[MAX_SUBMIT_SEMAPHORES];
+    uint64_t    signalValues[MAX_SUBMIT_SEMAPHORES];
+    uint32_t    signalCount = 0;
+
+    // per-frame synchronization, values are ignored for binary semaphores
+    AsyncQueue* asyncQueue = getAsyncQueue(get(cmd).queueType);
+    VkFence     vkFence    = VK_NULL_HANDLE;
+    if (cmd == m_commandBuffers[m_currentFrame]) {
+        // every window acquired this frame is rendered by this submission
+        for (uint32_t i = 0; i < m_frameWindowCount; i++) {
+            const WindowObject& windowObject = get(m_frameWindows[i]);
+
+            waitSemaphores[waitCount] = windowObject.vkImageAvailableSemaphores[m_currentFrame];
+            waitValues[waitCount]     = 0;
+            waitStages[waitCount]     = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            waitCount++;
+
+            signalSemaphores[signalCount] = windowObject.vkRenderFinishedSemaphores[m_currentFrame];
+            signalValues[signalCount]     = 0;
+            signalCount++;
+        }
+
+        // make the copies submitted since the last frame visible
+        if (m_pendingCopyValue != 0) {
+            waitSemaphores[waitCount] = get(m_submitTimeline).vkSemaphore;
+            waitValues[waitCount]     = m_pendingCopyValue;
+            waitStages[waitCount]     = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            waitCount++;
+
+            m_pendingCopyValue = 0;
+        }
+        if (m_pendingUploadValue != 0) {
+            waitSemaphores[waitCount] = get(m_asyncQueues[ASYNC_TRANSFER].timeline).vkSemaphore;
+            waitValues[waitCount]     = m_pendingUploadValue;
+            waitStages[waitCount]     = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            waitCount++;
+
+            m_pendingUploadValue = 0;
+        }
+
+        vkFence = get(m_inFlightFences[m_currentFrame]).vkFence;
+        resetFences(m_inFlightFences[m_currentFrame], 1);
+
+        m_isFrameQueryWritten[m_currentFrame] = true;
+    }
+
+    // caller synchronization
+    for (const TimelinePoint& wait : waits) {
+        waitSemaphores[waitCount] = get(wait.timeline).vkSemaphore;
+        waitValues[waitCount]     = wait.value;
+        waitStages[waitCount]     = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        waitCount++;
+    }
+
+    for (const TimelinePoint& signal : signals) {
+        signalSemaphores[signalCount] = get(signal.timeline).vkSemaphore;
+        signalValues[signalCount]     = signal.value;
+        signalCount++;
+    }
+
+    // every submission advances the submit value and signals it on the timeline of its queue
+    m_submitValue++;
+    Timeline timeline = m_submitTimeline;
+    VkQueue  vkQueue  = m_graphicsQueue;
+    if (asyncQueue != nullptr) {
+        timeline                   = asyncQueue->timeline;
+        vkQueue                    = asyncQueue->vkQueue;
+        asyncQueue->submittedValue = m_submitValue;
+    } else {
+        m_graphicsSubmitValue = m_submitValue;
+    }
+
+    // objects freed while the frame command buffer is recorded may be referenced by it and wait for its submission,
+    // outside of a frame recording, e.g. while loading, they retire with any submission
+    const bool isFrameCmd       = cmd == m_commandBuffers[m_currentFrame];
+    const bool isFrameRecording = !isFrameCmd && get(m_commandBuffers[m_currentFrame]).isSubmitPending;
+    if (!isFrameRecording) {
+        m_objects->deletionQueue.resolvePending(m_submitValue);
+    }
+    get(cmd).isSubmitPending = false;
+
+    signalSemaphores[signalCount] = get(timeline).vkSemaphore;
+    signalValues[signalCount]     = m_submitValue;
+    signalCount++;
 
-void GraphicsDevice::submitCmd(CommandBuffer cmd) const {
-    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     {
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType                     = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount   = waitCount;
+        timelineInfo.pWaitSemaphoreValues      = waitValues;
+        timelineInfo.signalSemaphoreValueCount = signalCount;
+        timelineInfo.pSignalSemaphoreValues    = signalValues;
+
         VkSubmitInfo submitInfo{};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.pNext = &timelineInfo;
 
-        submitInfo.waitSemaphoreCount   = 1;
-        submitInfo.pWaitSemaphores      = &m_imageAvailableSemaphores[m_currentFrame]->vkSemaphore;
-        submitInfo.pWaitDstStageMask    = &waitStage;
+        submitInfo.waitSemaphoreCount   = waitCount;
+        submitInfo.pWaitSemaphores      = waitSemaphores;
+        submitInfo.pWaitDstStageMask    = waitStages;
         submitInfo.commandBufferCount   = 1;
-        submitInfo.pCommandBuffers      = &cmd->vkCommandBuffer;
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores    = &m_renderFinishedSemaphores[m_currentFrame]->vkSemaphore;
+        submitInfo.pCommandBuffers      = &get(cmd).vkCommandBuffer;
+        submitInfo.signalSemaphoreCount = signalCount;
+        submitInfo.pSignalSemaphores    = signalSemaphores;
+
+        OZ_VK_ASSERT(vkQueueSubmit(vkQueue, 1, &submitInfo, vkFence));
+    }
+
+    m_frameStats.commands += get(cmd).stats;
+    m_frameStats.submittedCommandBuffers++;
+
+    // readbacks recorded into the submission complete with it
+    for (Buffer readback : get(cmd).readbacks) {
+        BufferObject& bufferObject     = get(readback);
+        bufferObject.readbackPoint     = TimelinePoint(timeline, m_submitValue);
+        bufferObject.isReadbackPending = false;
+    }
+
+    // executed bundles are in use until the submission has completed
+    for (CommandBuffer bundle : get(cmd).executedBundles) {
+        CommandBufferObject& bundleObject = get(bundle);
+        bundleObject.pendingExecutions--;
+        bundleObject.executedPoint = TimelinePoint(timeline, m_submitValue);
+    }
+    get(cmd).executedBundles.clear();
 
-        OZ_VK_ASSERT(vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_inFlightFences[m_currentFrame]->vkFence));
+    // frames collect in beginFrame, submissions outside of them collect too, so frees do not pile up while loading
+    if (!isFrameCmd && !isFrameRecording && !m_objects->deletionQueue.empty()) {
+        collectRetiredObjects(getCompletedSubmitValue());
     }
+
+    OZ_CAPTURE(SubmitCmd, cmd, waits, signals, TimelinePoint(timeline, m_submitValue));
+    return TimelinePoint(timeline, m_submitValue);
 }
 
-void GraphicsDevice::beginRenderPass(CommandBuffer cmd, RenderPass renderPass, uint32_t imageIndex) const {
+void GraphicsDevice::beginRenderPass(CommandBuffer cmd, RenderPass renderPass, uint32_t imageIndex, RenderPassContents contents) const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BeginRenderPass, cmd, renderPass, imageIndex, contents);
+
+    const RenderPassObject& renderPassObject = get(renderPass);
+
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType             = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass        = renderPass->vkRenderPass;
-    renderPassInfo.framebuffer       = renderPass->vkFrameBuffers[imageIndex];
+    renderPassInfo.renderPass        = renderPassObject.vkRenderPass;
+    renderPassInfo.framebuffer       = renderPassObject.vkFrameBuffers[imageIndex];
     renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = renderPass->vkExtent;
+    renderPassInfo.renderArea.extent = renderPassObject.vkExtent;
     VkClearValue clearColor          = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
     renderPassInfo.clearValueCount   = 1;
     renderPassInfo.pClearValues      = &clearColor;
 
-    vkCmdBeginRenderPass(cmd->vkCommandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(cmd->vkCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderPass->vkGraphicsPipeline);
+    if (contents == RenderPassContents::Bundles) {
+        // state is bound by the bundles themselves
+        vkCmdBeginRenderPass(get(cmd).vkCommandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        return;
+    }
+
+    vkCmdBeginRenderPass(get(cmd).vkCommandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    bindPipelineState(get(cmd), renderPassObject);
+}
+
+void GraphicsDevice::endRenderPass(CommandBuffer cmd) const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(EndRenderPass, cmd);
+
+    vkCmdEndRenderPass(get(cmd).vkCommandBuffer);
+}
+
+void GraphicsDevice::beginRendering(CommandBuffer cmd, std::initializer_list<RenderingAttachment> colorAttachments, RenderPassContents contents) {
+    beginRendering(cmd, std::span<const RenderingAttachment>(colorAttachments.begin(), colorAttachments.size()), contents);
+}
 
-    VkViewport viewport{};
-    viewport.x        = 0.0f;
-    viewport.y        = 0.0f;
-    viewport.width    = static_cast<float>(renderPass->vkExtent.width);
-    viewport.height   = static_cast<float>(renderPass->vkExtent.height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    vkCmdSetViewport(cmd->vkCommandBuffer, 0, 1, &viewport);
+void GraphicsDevice::beginRendering(CommandBuffer cmd, std::span<const RenderingAttachment> colorAttachments, RenderPassContents contents) {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BeginRendering, cmd, colorAttachments, contents);
+
+    assert(m_isDynamicRenderingSupported);
+    assert(colorAttachments.size() > 0 && colorAttachments.size() <= MAX_RENDERING_ATTACHMENTS);
+
+    CommandBufferObject& cmdObject = get(cmd);
+
+    VkRenderingAttachmentInfo vkAttachments[MAX_RENDERING_ATTACHMENTS];
+    VkImageMemoryBarrier      barriers[MAX_RENDERING_ATTACHMENTS];
+    uint32_t                  attachmentCount = 0;
+    VkExtent2D                extent          = get(colorAttachments.front().window).vkSwapChainExtent;
+
+    for (const RenderingAttachment& attachment : colorAttachments) {
+        const WindowObject& windowObject = get(attachment.window);
+        assert(windowObject.vkSwapChainExtent.width == extent.width && windowObject.vkSwapChainExtent.height == extent.height);
+
+        VkRenderingAttachmentInfo& vkAttachment = vkAttachments[attachmentCount];
+        vkAttachment                            = {};
+        vkAttachment.sType                      = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        vkAttachment.imageView                  = windowObject.vkSwapChainImageViews[attachment.imageIndex];
+        vkAttachment.imageLayout                = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        vkAttachment.loadOp                     = attachment.clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        vkAttachment.storeOp                    = VK_ATTACHMENT_STORE_OP_STORE;
+        std::memcpy(vkAttachment.clearValue.color.float32, &attachment.clearColor, sizeof(float) * 4);
+
+        // swap chain images are kept in the present layout between passes, cleared ones can discard their contents
+        VkImageMemoryBarrier& barrier           = barriers[attachmentCount];
+        barrier                                 = {};
+        barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask                   = 0;
+        barrier.dstAccessMask                   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (attachment.clear ? 0 : VK_ACCESS_COLOR_ATTACHMENT_READ_BIT);
+        barrier.oldLayout                       = attachment.clear ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.newLayout                       = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                           = windowObject.vkSwapChainImages[attachment.imageIndex];
+        barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount     = 1;
+        barrier.subresourceRange.layerCount     = 1;
+
+        cmdObject.vkRenderingImages[attachmentCount] = barrier.image;
+        attachmentCount++;
+    }
 
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = renderPass->vkExtent;
-    vkCmdSetScissor(cmd->vkCommandBuffer, 0, 1, &scissor);
+    // the frame submission waits for the acquired images at the color attachment output stage
+    vkCmdPipelineBarrier(cmdObject.vkCommandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         attachmentCount,
+                         barriers);
+
+    VkRenderingInfo renderingInfo{};
+    renderingInfo.sType                = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    renderingInfo.flags                = contents == RenderPassContents::Bundles ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
+    renderingInfo.renderArea.offset    = {0, 0};
+    renderingInfo.renderArea.extent    = extent;
+    renderingInfo.layerCount           = 1;
+    renderingInfo.colorAttachmentCount = attachmentCount;
+    renderingInfo.pColorAttachments    = vkAttachments;
+
+    m_vkCmdBeginRendering(cmdObject.vkCommandBuffer, &renderingInfo);
+
+    cmdObject.renderingImageCount = attachmentCount;
+    cmdObject.vkRenderingExtent   = extent;
 }
 
-void GraphicsDevice::endRenderPass(CommandBuffer cmd) const { vkCmdEndRenderPass(cmd->vkCommandBuffer); }
+void GraphicsDevice::endRendering(CommandBuffer cmd) {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(EndRendering, cmd);
+
+    CommandBufferObject& cmdObject = get(cmd);
+    m_vkCmdEndRendering(cmdObject.vkCommandBuffer);
+
+    // back to the present layout
+    VkImageMemoryBarrier barriers[MAX_RENDERING_ATTACHMENTS];
+    for (uint32_t i = 0; i < cmdObject.renderingImageCount; i++) {
+        VkImageMemoryBarrier& barrier       = barriers[i];
+        barrier                             = {};
+        barrier.sType                       = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask               = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask               = 0;
+        barrier.oldLayout                   = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout                   = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.srcQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex         = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image                       = cmdObject.vkRenderingImages[i];
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+    }
+
+    vkCmdPipelineBarrier(cmdObject.vkCommandBuffer,
+                         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr,
+                         cmdObject.renderingImageCount,
+                         barriers);
+
+    cmdObject.renderingImageCount = 0;
+    cmdObject.vkRenderingExtent   = {};
+}
 
 void GraphicsDevice::draw(CommandBuffer cmd, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) const {
-    vkCmdDraw(cmd->vkCommandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(Draw, cmd, vertexCount, instanceCount, firstVertex, firstInstance);
+
+    CommandBufferObject& cmdObject = get(cmd);
+    vkCmdDraw(cmdObject.vkCommandBuffer, vertexCount, instanceCount, firstVertex, firstInstance);
+    cmdObject.stats.draws.calls++;
+    cmdObject.stats.draws.instances += instanceCount;
+    cmdObject.stats.draws.vertices += vertexCount;
 }
 
 void GraphicsDevice::drawIndexed(
     CommandBuffer cmd, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, uint32_t vertexOffset, uint32_t firstInstance) const {
-    vkCmdDrawIndexed(cmd->vkCommandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(DrawIndexed, cmd, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+
+    CommandBufferObject& cmdObject = get(cmd);
+    vkCmdDrawIndexed(cmdObject.vkCommandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    cmdObject.stats.draws.calls++;
+    cmdObject.stats.draws.instances += instanceCount;
+    cmdObject.stats.draws.indices += indexCount;
+}
+
+void GraphicsDevice::bindPipeline(CommandBuffer cmd, RenderPass renderPass) const {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BindPipeline, cmd, renderPass);
+
+    bindPipelineState(get(cmd), get(renderPass));
 }
 
 void GraphicsDevice::bindVertexBuffer(CommandBuffer cmd, Buffer vertexBuffer) {
-    VkBuffer vertexBuffers[] = {vertexBuffer->vkBuffer};    
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(cmd->vkCommandBuffer, 0, 1, vertexBuffers, offsets);
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BindVertexBuffer, cmd, vertexBuffer);
+
+    CommandBufferObject& cmdObject = get(cmd);
+    VkBuffer             vkBuffer  = get(vertexBuffer).vkBuffer;
+    if (cmdObject.vkBoundVertexBuffer == vkBuffer) {
+        cmdObject.stats.vertexBuffer.elided++;
+        return;
+    }
+
+    VkBuffer     vertexBuffers[] = {vkBuffer};
+    VkDeviceSize offsets[]       = {0};
+    vkCmdBindVertexBuffers(cmdObject.vkCommandBuffer, 0, 1, vertexBuffers, offsets);
+
+    cmdObject.vkBoundVertexBuffer = vkBuffer;
+    cmdObject.stats.vertexBuffer.issued++;
+}
+
+void GraphicsDevice::bindIndexBuffer(CommandBuffer cmd, Buffer indexBuffer, IndexType indexType) {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BindIndexBuffer, cmd, indexBuffer, indexType);
+
+    CommandBufferObject& cmdObject   = get(cmd);
+    VkBuffer             vkBuffer    = get(indexBuffer).vkBuffer;
+    VkIndexType          vkIndexType = indexType == IndexType::Uint32 ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+    if (cmdObject.vkBoundIndexBuffer == vkBuffer && cmdObject.vkBoundIndexType == vkIndexType) {
+        cmdObject.stats.indexBuffer.elided++;
+        return;
+    }
+
+    vkCmdBindIndexBuffer(cmdObject.vkCommandBuffer, vkBuffer, 0, vkIndexType);
+
+    cmdObject.vkBoundIndexBuffer = vkBuffer;
+    cmdObject.vkBoundIndexType   = vkIndexType;
+    cmdObject.stats.indexBuffer.issued++;
 }
 
-void GraphicsDevice::bindIndexBuffer(CommandBuffer cmd, Buffer indexBuffer) {
-    vkCmdBindIndexBuffer(cmd->vkCommandBuffer, indexBuffer->vkBuffer, 0, VK_INDEX_TYPE_UINT16);
+void GraphicsDevice::bindDescriptorSet(
+    CommandBuffer cmd, RenderPass renderPass, DescriptorSet descriptorSet, uint32_t setIndex, std::initializer_list<uint32_t> dynamicOffsets) {
+    bindDescriptorSet(cmd, renderPass, descriptorSet, setIndex, std::span<const uint32_t>(dynamicOffsets.begin(), dynamicOffsets.size()));
 }
 
-void GraphicsDevice::bindDescriptorSet(CommandBuffer cmd, RenderPass renderPass, DescriptorSet descriptorSet, uint32_t setIndex) {
-    vkCmdBindDescriptorSets(cmd->vkCommandBuffer,
+void GraphicsDevice::bindDescriptorSet(
+    CommandBuffer cmd, RenderPass renderPass, DescriptorSet descriptorSet, uint32_t setIndex, std::span<const uint32_t> dynamicOffsets) {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(BindDescriptorSet, cmd, renderPass, descriptorSet, setIndex, dynamicOffsets);
+
+    assert(setIndex < MAX_BOUND_DESCRIPTOR_SETS);
+
+    CommandBufferObject& cmdObject        = get(cmd);
+    VkPipelineLayout     vkPipelineLayout = get(renderPass).vkPipelineLayout;
+    VkDescriptorSet      vkDescriptorSet  = get(descriptorSet).vkDescriptorSet;
+
+    // sets bound with another layout are not tracked
+    if (cmdObject.vkBoundPipelineLayout != vkPipelineLayout) {
+        cmdObject.vkBoundPipelineLayout = vkPipelineLayout;
+        cmdObject.vkBoundDescriptorSets = {};
+    }
+
+    // offsets usually change per draw, so sets with dynamic offsets are always rebound
+    if (dynamicOffsets.size() == 0 && cmdObject.vkBoundDescriptorSets[setIndex] == vkDescriptorSet) {
+        cmdObject.stats.descriptorSet.elided++;
+        return;
+    }
+
+    vkCmdBindDescriptorSets(cmdObject.vkCommandBuffer,
                             VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            renderPass->vkPipelineLayout,
+                            vkPipelineLayout,
                             setIndex,
                             1,
-                            &(descriptorSet->vkDescriptorSet),
-                            0,
-                            nullptr);
+                            &vkDescriptorSet,
+                            static_cast<uint32_t>(dynamicOffsets.size()),
+                            dynamicOffsets.data());
+
+    cmdObject.vkBoundDescriptorSets[setIndex] = vkDescriptorSet;
+    cmdObject.stats.descriptorSet.issued++;
 }
 
-void GraphicsDevice::updateBuffer(Buffer buffer, const void* data, size_t size) { memcpy(buffer->data, data, size); }
+bool GraphicsDevice::beginBundle(CommandBuffer bundle, RenderPass renderPass, uint64_t inputsVersion) {
+    OZ_CAPTURE_SCOPE();
+
+    CommandBufferObject&    bundleObject     = get(bundle);
+    const RenderPassObject& renderPassObject = get(renderPass);
+    assert(bundleObject.isBundle);
+
+    if (bundleObject.isRecorded && bundleObject.recordedVersion == inputsVersion && bundleObject.recordedRenderPass == renderPass) {
+        OZ_CAPTURE(BeginBundle, bundle, renderPass, inputsVersion, false);
+        return false;
+    }
+
+    // resetting the recording would invalidate the command buffers that execute it and are not submitted yet
+    if (bundleObject.pendingExecutions > 0) {
+        throw std::runtime_error("Bundle re-recorded before the command buffer executing it was submitted!");
+    }
+
+    // the previous recording might still be in use by a submission
+    if (bundleObject.executedPoint.value != 0) {
+        waitTimeline(bundleObject.executedPoint.timeline, bundleObject.executedPoint.value);
+        bundleObject.executedPoint = {};
+    }
+
+    vkResetCommandBuffer(bundleObject.vkCommandBuffer, 0);
+    bundleObject.resetBoundState();
+
+    // dynamic rendering passes are inherited by their attachment formats
+    VkCommandBufferInheritanceRenderingInfo renderingInfo{};
+    renderingInfo.sType                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+    renderingInfo.flags                   = 0;
+    renderingInfo.colorAttachmentCount    = static_cast<uint32_t>(renderPassObject.vkColorFormats.size());
+    renderingInfo.pColorAttachmentFormats = renderPassObject.vkColorFormats.data();
+    renderingInfo.rasterizationSamples    = VK_SAMPLE_COUNT_1_BIT;
 
-void GraphicsDevice::copyBuffer(Buffer src, Buffer dst, uint64_t size) {
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool        = m_commandPool;
-    allocInfo.commandBufferCount = 1;
+    // no framebuffer, so the bundle can be executed for every swap chain image of the render pass
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.pNext       = renderPassObject.vkRenderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+    inheritanceInfo.renderPass  = renderPassObject.vkRenderPass;
+    inheritanceInfo.subpass     = 0;
+    inheritanceInfo.framebuffer = VK_NULL_HANDLE;
 
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer);
+    // the frame command buffer may execute the bundle while its pipeline statistics query is active
+    inheritanceInfo.pipelineStatistics = m_isPipelineStatsSupported ? PIPELINE_STATISTICS : 0;
 
     VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags            = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    OZ_VK_ASSERT(vkBeginCommandBuffer(bundleObject.vkCommandBuffer, &beginInfo));
+
+    bundleObject.isRecorded         = true;
+    bundleObject.recordedVersion    = inputsVersion;
+    bundleObject.recordedRenderPass = renderPass;
+
+    OZ_CAPTURE(BeginBundle, bundle, renderPass, inputsVersion, true);
+    return true;
+}
+
+void GraphicsDevice::invalidateBundle(CommandBuffer bundle) {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(InvalidateBundle, bundle);
+
+    get(bundle).isRecorded = false;
+}
+
+void GraphicsDevice::executeBundles(CommandBuffer cmd, std::initializer_list<CommandBuffer> bundles) {
+    executeBundles(cmd, std::span<const CommandBuffer>(bundles.begin(), bundles.size()));
+}
+
+void GraphicsDevice::executeBundles(CommandBuffer cmd, std::span<const CommandBuffer> bundles) {
+    static constexpr uint32_t MAX_EXECUTED_BUNDLES = 64;
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(ExecuteBundles, cmd, bundles);
+
+    assert(bundles.size() <= MAX_EXECUTED_BUNDLES);
 
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    CommandBufferObject& cmdObject = get(cmd);
+
+    VkCommandBuffer vkBundles[MAX_EXECUTED_BUNDLES];
+    uint32_t        bundleCount = 0;
+    for (CommandBuffer bundle : bundles) {
+        CommandBufferObject& bundleObject = get(bundle);
+        assert(bundleObject.isBundle && bundleObject.isRecorded);
+
+        bundleObject.pendingExecutions++;
+        cmdObject.executedBundles.push_back(bundle);
+        vkBundles[bundleCount++] = bundleObject.vkCommandBuffer;
+        cmdObject.stats += bundleObject.stats; // the commands run again with every execution
+    }
+
+    vkCmdExecuteCommands(cmdObject.vkCommandBuffer, bundleCount, vkBundles);
+    cmdObject.invalidateBoundState();
+}
+
+void GraphicsDevice::updateBuffer(Buffer buffer, const void* data, size_t size) {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(UpdateBuffer, buffer, CaptureBlob{data, size});
+
+    memcpy(get(buffer).data, data, size);
+    m_frameStats.uploadedBytes += size;
+}
+
+TimelinePoint GraphicsDevice::copyBuffer(Buffer src, Buffer dst, uint64_t size) {
+    OZ_CAPTURE_SCOPE();
+
+    CommandBuffer cmd = createCommandBuffer();
+    beginCmd(cmd, true);
 
     VkBufferCopy copyRegion{};
     copyRegion.srcOffset = 0;
     copyRegion.dstOffset = 0;
     copyRegion.size      = size;
-    vkCmdCopyBuffer(commandBuffer, src->vkBuffer, dst->vkBuffer, 1, &copyRegion);
+    vkCmdCopyBuffer(get(cmd).vkCommandBuffer, get(src).vkBuffer, get(dst).vkBuffer, 1, &copyRegion);
+
+    endCmd(cmd);
+
+    TimelinePoint copyPoint = submitCmd(cmd);
+    m_pendingCopyValue      = copyPoint.value;
+
+    // released once the copy has completed
+    free(cmd);
+
+    OZ_CAPTURE(CopyBuffer, src, dst, size, copyPoint);
+    return copyPoint;
+}
+
+void GraphicsDevice::readBuffer(CommandBuffer cmd, Buffer src, Buffer dst, uint64_t size, uint64_t srcOffset, uint64_t dstOffset) {
+    OZ_CAPTURE_SCOPE();
+    OZ_CAPTURE(ReadBuffer, cmd, src, dst, size, srcOffset, dstOffset);
+
+    CommandBufferObject& cmdObject = get(cmd);
+    BufferObject&        dstObject = get(dst);
+    assert(dstObject.data != nullptr); // has to be a readback buffer
+
+    // earlier writes to the source, e.g. by shaders, are complete before the copy reads it
+    VkMemoryBarrier barrier{};
+    barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(cmdObject.vkCommandBuffer,
+                         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0,
+                         1,
+                         &barrier,
+                         0,
+                         nullptr,
+                         0,
+                         nullptr);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = srcOffset;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size      = size;
+    vkCmdCopyBuffer(cmdObject.vkCommandBuffer, get(src).vkBuffer, dstObject.vkBuffer, 1, &copyRegion);
+
+    // the copy is made available to host reads, which start once the submission signaled its timeline
+    VkBufferMemoryBarrier hostBarrier{};
+    hostBarrier.sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask       = VK_ACCESS_HOST_READ_BIT;
+    hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.buffer              = dstObject.vkBuffer;
+    hostBarrier.offset              = dstOffset;
+    hostBarrier.size                = size;
+    vkCmdPipelineBarrier(cmdObject.vkCommandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_HOST_BIT,
+                         0,
+                         0,
+                         nullptr,
+                         1,
+                         &hostBarrier,
+                         0,
+                         nullptr);
+
+    dstObject.isReadbackIssued  = true;
+    dstObject.isReadbackPending = true;
+    dstObject.readbackPoint     = {};
+    cmdObject.readbacks.push_back(dst);
+}
+
+bool GraphicsDevice::isReadbackComplete(Buffer dst) const {
+    const BufferObject& bufferObject = get(dst);
+    assert(bufferObject.isReadbackIssued); // the contents of a buffer that was never read back are undefined
+    if (!bufferObject.isReadbackIssued || bufferObject.isReadbackPending) {
+        return false; // not recorded or not submitted yet
+    }
+    return isComplete(bufferObject.readbackPoint);
+}
+
+const void* GraphicsDevice::getReadbackData(Buffer dst) const {
+    if (!isReadbackComplete(dst)) {
+        return nullptr;
+    }
+
+    // cached memory that is not coherent has to be invalidated before the host sees the GPU writes
+    const BufferObject& bufferObject = get(dst);
+    if (!bufferObject.isHostCoherent) {
+        VkMappedMemoryRange range{};
+        range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = bufferObject.vkMemory;
+        range.offset = 0;
+        range.size   = VK_WHOLE_SIZE;
+        [[maybe_unused]] const VkResult result = vkInvalidateMappedMemoryRanges(m_device, 1, &range);
+        OZ_VK_ASSERT(result);
+    }
+    return bufferObject.data;
+}
+
+TimelinePoint GraphicsDevice::uploadBuffer(Buffer dst, const void* data, uint64_t size, uint64_t dstOffset) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    return uploadBuffer(
+        dst, size, [bytes](void* chunk, uint64_t offset, uint64_t chunkSize) { memcpy(chunk, bytes + offset, chunkSize); }, dstOffset);
+}
+
+GraphicsDevice::StagingChunk GraphicsDevice::acquireStagingChunk(uint64_t maxSize) {
+    OZ_CAPTURE_SCOPE(); // the wait for the slot is part of the upload
+    const uint32_t slotIndex = m_stagingSlotIndex;
+    m_stagingSlotIndex       = (m_stagingSlotIndex + 1) % STAGING_CHUNK_COUNT;
+
+    // the upload that used the slot last has to be done reading it
+    const StagingSlot& slot = m_stagingSlots[slotIndex];
+    if (slot.point.value != 0) {
+        waitTimeline(slot.point.timeline, slot.point.value);
+    }
+
+    StagingChunk chunk;
+    chunk.data = static_cast<uint8_t*>(get(m_stagingRing).data) + slotIndex * STAGING_CHUNK_SIZE;
+    chunk.size = std::min(maxSize, STAGING_CHUNK_SIZE);
+    chunk.slot = slotIndex;
+    return chunk;
+}
+
+TimelinePoint GraphicsDevice::submitStagingChunk(const StagingChunk& chunk, Buffer dst, uint64_t dstOffset) {
+    OZ_CAPTURE_SCOPE();
+
+    StagingSlot& slot = m_stagingSlots[chunk.slot];
+    beginCmd(slot.cmd, true);
+
+    VkBufferCopy copyRegion{};
+    copyRegion.srcOffset = chunk.slot * STAGING_CHUNK_SIZE;
+    copyRegion.dstOffset = dstOffset;
+    copyRegion.size      = chunk.size;
+    vkCmdCopyBuffer(get(slot.cmd).vkCommandBuffer, get(m_stagingRing).vkBuffer, get(dst).vkBuffer, 1, &copyRegion);
+
+    endCmd(slot.cmd);
+    slot.point = submitCmd(slot.cmd);
 
-    vkEndCommandBuffer(commandBuffer);
+    // the next frame submission waits for the upload
+    if (get(slot.cmd).queueType == QueueType::Transfer) {
+        m_pendingUploadValue = slot.point.value;
+    } else {
+        m_pendingCopyValue = slot.point.value;
+    }
 
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers    = &commandBuffer;
+    m_frameStats.uploadedBytes += chunk.size;
+
+    // recorded per chunk, so uploads filled by a callback are captured as well
+    OZ_CAPTURE(UploadBuffer, dst, dstOffset, CaptureBlob{chunk.data, chunk.size}, slot.point);
+    return slot.point;
+}
 
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_graphicsQueue);
+void GraphicsDevice::captureMappedData() {
+    // uniforms allocated since the last submission
+    if (m_uniformOffset > m_capture->uniformOffset) {
+        const uint64_t offset = m_capture->uniformOffset;
+        const uint8_t* data   = static_cast<const uint8_t*>(get(m_uniformRing).data) + offset;
+        m_capture->record(CaptureCommand::WriteMappedData, m_uniformRing, offset, CaptureBlob{data, m_uniformOffset - offset});
+        m_capture->uniformOffset = m_uniformOffset;
+    }
 
-    vkFreeCommandBuffers(m_device, m_commandPool, 1, &commandBuffer);
+    // the written ranges of other buffers are unknown, they are stored whole
+    for (Buffer buffer : m_capture->mappedBuffers) {
+        const BufferObject& bufferObject = get(buffer);
+        m_capture->record(CaptureCommand::WriteMappedData, buffer, uint64_t(0), CaptureBlob{bufferObject.data, bufferObject.size});
+    }
 }
 
-void GraphicsDevice::free(Window window) const { OZ_FREE_VK_OBJECT(m_device, window); }
-void GraphicsDevice::free(Shader shader) const { OZ_FREE_VK_OBJECT(m_device, shader); }
-void GraphicsDevice::free(RenderPass renderPass) const { OZ_FREE_VK_OBJECT(m_device, renderPass) }
-void GraphicsDevice::free(Semaphore semaphore) const { OZ_FREE_VK_OBJECT(m_device, semaphore); }
-void GraphicsDevice::free(Fence fence) const { OZ_FREE_VK_OBJECT(m_device, fence); }
-void GraphicsDevice::free(CommandBuffer commandBuffer) const { OZ_FREE_VK_OBJECT(m_device, commandBuffer); }
-void GraphicsDevice::free(Buffer buffer) const { OZ_FREE_VK_OBJECT(m_device, buffer); }
-void GraphicsDevice::free(DescriptorSetLayout descriptorSetLayout) const { OZ_FREE_VK_OBJECT(m_device, descriptorSetLayout); }
+void GraphicsDevice::free(Window window) const { retire(window); }
+void GraphicsDevice::free(Shader shader) const { retire(shader); }
+void GraphicsDevice::free(RenderPass renderPass) const { retire(renderPass); }
+void GraphicsDevice::free(Semaphore semaphore) const { retire(semaphore); }
+void GraphicsDevice::free(Timeline timeline) const { retire(timeline); }
+void GraphicsDevice::free(Fence fence) const { retire(fence); }
+void GraphicsDevice::free(CommandBuffer commandBuffer) const { retire(commandBuffer); }
+void GraphicsDevice::free(Buffer buffer) const {
+    if (m_capture != nullptr) {
+        std::erase(m_capture->mappedBuffers, buffer);
+    }
+    retire(buffer);
+}
+void GraphicsDevice::free(DescriptorSetLayout descriptorSetLayout) const { retire(descriptorSetLayout); }
+void GraphicsDevice::free(DescriptorSet descriptorSet) const { retire(descriptorSet); }
 
 } // namespace oz::gfx::vk
\ No newline at end of file
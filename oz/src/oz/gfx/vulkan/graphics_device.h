@@ -1,13 +1,27 @@
 #pragma once
 
 #include "oz/gfx/vulkan/common.h"
+#include "oz/gfx/vulkan/frame_pacer.h"
 #include "oz/gfx/vulkan/objects.h"
 #include "oz/gfx/vulkan/property_structs.h"
+#include "oz/gfx/vulkan/stats.h"
+
 namespace oz::gfx::vk {
 
+struct ObjectPools;
+class CaptureWriter;
+class HostAllocator;
+
 class GraphicsDevice final {
   public:
-    GraphicsDevice(const bool enableValidationLayers = false);
+    static constexpr uint32_t MAX_FRAME_WINDOWS = 8;
+
+    // the capture falls back to the OZ_CAPTURE_PATH and OZ_CAPTURE_FRAMES environment variables
+    GraphicsDevice(const bool                 enableValidationLayers = false,
+                   const DeviceSelectionInfo& deviceSelection        = {},
+                   const CaptureInfo&         capture                = {},
+                   const HostAllocatorInfo&   hostAllocator          = {},
+                   const ObjectCapacityInfo&  objectCapacities       = {});
 
     GraphicsDevice(const GraphicsDevice&)            = delete;
     GraphicsDevice& operator=(const GraphicsDevice&) = delete;
@@ -19,40 +33,125 @@ class GraphicsDevice final {
   public:
     // create methods
     Window              createWindow(uint32_t width, uint32_t height, const char* name = "");
-    CommandBuffer       createCommandBuffer();
-    Shader              createShader(const std::string& path, ShaderStage stage);
+    // command buffers of the compute and transfer queues run concurrently with graphics, see hasDedicatedQueue
+    CommandBuffer       createCommandBuffer(QueueType queueType = QueueType::Graphics);
+    // secondary command buffer for static content, see beginBundle
+    CommandBuffer       createCommandBundle();
+    // the specialization constants are defaults, the ones passed at pipeline creation override them
+    Shader              createShader(const std::string& path, ShaderStage stage, const SpecializationConstants& specialization = {});
+    // from SPIR-V code
+    Shader              createShader(const std::vector<char>& code, ShaderStage stage, const SpecializationConstants& specialization = {});
     RenderPass          createRenderPass(Shader                                  vertexShader,
                                          Shader                                  fragmentShader,
                                          Window                                  window,
                                          const VertexLayoutInfo&                 vertexLayout,
-                                         const std::vector<DescriptorSetLayout>& descriptorSetLayouts);
+                                         const std::vector<DescriptorSetLayout>& descriptorSetLayouts,
+                                         const SpecializationConstants&          specialization = {});
+    // pipeline for beginRendering, no render pass or frame buffers are created and the attachments can change per frame
+    // as long as their formats match the ones of the window, requires isDynamicRenderingSupported
+    RenderPass          createDynamicRenderPass(Shader                                  vertexShader,
+                                                Shader                                  fragmentShader,
+                                                Window                                  window,
+                                                const VertexLayoutInfo&                 vertexLayout,
+                                                const std::vector<DescriptorSetLayout>& descriptorSetLayouts,
+                                                const SpecializationConstants&          specialization = {});
     Semaphore           createSemaphore();
+    Timeline            createTimeline(uint64_t initialValue = 0);
     Fence               createFence();
     Buffer              createBuffer(BufferType bufferType, uint64_t size, const void* data = nullptr);
     DescriptorSetLayout createDescriptorSetLayout(const DescriptorSetLayoutInfo& setLayout);
     DescriptorSet       createDescriptorSet(DescriptorSetLayout descriptorSetLayout, const DescriptorSetInfo& descriptorSetInfo);
 
     // sync methods
-    void waitIdle() const;
+    void waitIdle() const; // also releases the frees, except the ones made during an open frame recording
     void waitGraphicsQueueIdle() const;
     void waitFences(Fence fence, uint32_t fenceCount, bool waitAll = true) const;
     void resetFences(Fence fence, uint32_t fenceCount) const;
 
+    // timeline methods
+    bool     isComplete(Timeline timeline, uint64_t value) const;
+    bool     isComplete(const TimelinePoint& point) const;
+    uint64_t getTimelineValue(Timeline timeline) const;
+    void     waitTimeline(Timeline timeline, uint64_t value) const;
+    void     signalTimeline(Timeline timeline, uint64_t value) const;
+
+    // transient uniform methods
+    // allocations come from a persistently mapped ring buffer and are valid until the end of the current frame
+    // the first allocation of a frame begins the frame if getCurrentImage or beginFrame was not called before
+    // bind them through UniformDynamic bindings of a set created on getUniformRing() with the allocation offset
+    UniformAllocation allocateUniform(size_t size);
+    template <typename T>
+    uint32_t pushUniform(const T& value) {
+        UniformAllocation allocation = allocateUniform(sizeof(T));
+        std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation.offset;
+    }
+    Buffer getUniformRing() const;
+
     // state getters
     CommandBuffer getCurrentCommandBuffer() const;
-    uint32_t      getCurrentImage(Window window) const;
+    // acquires the next image of the window for the current frame, begins the frame on the first call
+    // throws if the swap chain of the window is out of date, swap chains are not recreated
+    uint32_t      getCurrentImage(Window window);
     uint32_t      getCurrentFrame() const;
+    // persistently mapped memory of uniform and storage buffers
+    void*         getBufferData(Buffer buffer) const;
+
+    // Vulkan 1.3 or VK_KHR_dynamic_rendering
+    bool          isDynamicRenderingSupported() const;
+    // the queue type has its own queue family. Without one, transfer command buffers go to the compute queue if there
+    // is one and every other queue type goes to the graphics queue.
+    bool          hasDedicatedQueue(QueueType queueType) const;
+
+    // commands recorded and binds skipped since the last beginCmd, executed bundles included
+    const CommandStats& getCommandStats(CommandBuffer cmd) const;
+
+    // frame methods
+    // the frame, command, bind, draw, update and submit methods do not allocate from the heap once the deletion queue
+    // and the readback and executed bundle lists have grown to the size of a steady-state frame, see oz_frame_allocation_test
+    // sleeps until just before the frame in flight is predicted to be available, call before pollEvents so input is
+    // sampled as late as possible
+    void paceFrame();
+    // waits for the frame in flight to be available, called by the first getCurrentImage or allocateUniform of a frame if
+    // not called before
+    void beginFrame();
+    // presents every window acquired in the frame with a single present call and moves to the next frame
+    // the current frame command buffer submission waits for and signals the semaphores of those windows
+    void presentFrame();
+    // timings of the last presented frame
+    const FrameTimingStats& getFrameTimingStats() const;
+    // commands submitted in the last presented frame, pipeline statistics if the device supports them
+    const FrameStats&       getFrameStats() const;
+    // host memory of the driver, all zero if the host allocator is disabled
+    HostMemoryStats         getHostMemoryStats() const;
 
     // window methods
+    // processes window and input events, the time of the latest call is the input sample of the frame
+    void pollEvents();
     bool isWindowOpen(Window window) const;
-    void presentImage(Window window, uint32_t imageIndex);
 
     // commands methods
     void beginCmd(CommandBuffer cmd, bool isSingleUse = false) const;
     void endCmd(CommandBuffer cmd) const;
-    void submitCmd(CommandBuffer cmd) const;
-    void beginRenderPass(CommandBuffer cmd, RenderPass renderPass, uint32_t imageIndex) const;
+    // submits to the queue of the command buffer, the submission signals the returned point once it has completed on the GPU
+    // waits and signals are applied in addition to the per-frame synchronization of the current frame command buffer
+    // submissions to different queues are only ordered through waits on the returned points
+    TimelinePoint submitCmd(CommandBuffer                        cmd,
+                            std::initializer_list<TimelinePoint> waits   = {},
+                            std::initializer_list<TimelinePoint> signals = {});
+    TimelinePoint submitCmd(CommandBuffer cmd, std::span<const TimelinePoint> waits, std::span<const TimelinePoint> signals);
+    void beginRenderPass(CommandBuffer      cmd,
+                         RenderPass         renderPass,
+                         uint32_t           imageIndex,
+                         RenderPassContents contents = RenderPassContents::Inline) const;
     void endRenderPass(CommandBuffer cmd) const;
+    // dynamic rendering into swap chain images, use with pipelines of createDynamicRenderPass
+    // attachments are transitioned for rendering here and back to the present layout by endRendering
+    void beginRendering(CommandBuffer                              cmd,
+                        std::initializer_list<RenderingAttachment> colorAttachments,
+                        RenderPassContents                         contents = RenderPassContents::Inline);
+    void beginRendering(CommandBuffer cmd, std::span<const RenderingAttachment> colorAttachments, RenderPassContents contents);
+    void endRendering(CommandBuffer cmd);
     void draw(CommandBuffer cmd, uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) const;
     void drawIndexed(CommandBuffer cmd,
                      uint32_t      indexCount,
@@ -60,18 +159,73 @@ class GraphicsDevice final {
                      uint32_t      firstIndex    = 0,
                      uint32_t      vertexOffset  = 0,
                      uint32_t      firstInstance = 0) const;
+    // binds the pipeline of a render pass inside an already begun compatible render pass
+    void bindPipeline(CommandBuffer cmd, RenderPass renderPass) const;
     void bindVertexBuffer(CommandBuffer cmd, Buffer vertexBuffer);
-    void bindIndexBuffer(CommandBuffer cmd, Buffer indexBuffer);
-    void bindDescriptorSet(CommandBuffer cmd, RenderPass renderPass, DescriptorSet descriptorSet, uint32_t setIndex = 0);
+    void bindIndexBuffer(CommandBuffer cmd, Buffer indexBuffer, IndexType indexType = IndexType::Uint16);
+    // dynamic offsets are consumed in binding order by the UniformDynamic bindings of the set
+    void bindDescriptorSet(CommandBuffer                   cmd,
+                           RenderPass                      renderPass,
+                           DescriptorSet                   descriptorSet,
+                           uint32_t                        setIndex       = 0,
+                           std::initializer_list<uint32_t> dynamicOffsets = {});
+    void bindDescriptorSet(
+        CommandBuffer cmd, RenderPass renderPass, DescriptorSet descriptorSet, uint32_t setIndex, std::span<const uint32_t> dynamicOffsets);
+
+    // bundle methods
+    // Begins recording a bundle for the render pass unless it is already recorded for it with the same inputs version.
+    // Returns false if the recorded commands are still valid, nothing is recorded then. Otherwise record with the usual
+    // bind and draw calls and finish with endCmd. Re-recording an executed bundle waits for its latest submission and
+    // throws if a command buffer that executes it has not been submitted yet.
+    bool beginBundle(CommandBuffer bundle, RenderPass renderPass, uint64_t inputsVersion);
+    // forces the next beginBundle to record again
+    void invalidateBundle(CommandBuffer bundle);
+    // replays recorded bundles inside a render pass begun with RenderPassContents::Bundles
+    void executeBundles(CommandBuffer cmd, std::initializer_list<CommandBuffer> bundles);
+    void executeBundles(CommandBuffer cmd, std::span<const CommandBuffer> bundles);
 
     void updateBuffer(Buffer buffer, const void* data, size_t size);
-    void copyBuffer(Buffer src, Buffer dst, uint64_t size);
+    // does not block, the next frame submission waits for the copy
+    TimelinePoint copyBuffer(Buffer src, Buffer dst, uint64_t size);
+
+    // readback methods
+    // Records a copy of GPU written data into a BufferType::Readback buffer, made visible to the host once the
+    // submission of cmd has completed. Poll isReadbackComplete, usually a frame or more later, instead of waiting.
+    void        readBuffer(CommandBuffer cmd, Buffer src, Buffer dst, uint64_t size, uint64_t srcOffset = 0, uint64_t dstOffset = 0);
+    // dst has to have been passed to readBuffer before
+    bool        isReadbackComplete(Buffer dst) const;
+    // mapped data of a completed readback, nullptr while it is still in flight
+    const void* getReadbackData(Buffer dst) const;
+
+    // streaming upload methods
+    // Uploads through the fixed-size staging ring instead of a staging buffer as large as the data. The data is split
+    // into chunks that are submitted as soon as they are written and reused once the GPU consumed them, so only waits
+    // while every chunk is in flight. Runs on the transfer queue if there is one, the next frame submission waits for it.
+    // dst can be of any buffer type except Staging.
+    TimelinePoint uploadBuffer(Buffer dst, const void* data, uint64_t size, uint64_t dstOffset = 0);
+    // fill(void* chunk, uint64_t offset, uint64_t size) writes each chunk straight into the staging memory, e.g. from a
+    // file read, producing the next chunk overlaps with the transfer of the previous ones
+    template <typename F>
+    TimelinePoint uploadBuffer(Buffer dst, uint64_t size, F&& fill, uint64_t dstOffset = 0) {
+        TimelinePoint point;
+        for (uint64_t offset = 0; offset < size;) {
+            StagingChunk chunk = acquireStagingChunk(size - offset);
+            fill(chunk.data, offset, chunk.size);
+            point = submitStagingChunk(chunk, dst, dstOffset + offset);
+            offset += chunk.size;
+        }
+        return point;
+    }
 
     // free methods
+    // objects are destroyed once the submission that may reference them and everything submitted before it has
+    // completed, no waitIdle is needed: while the frame command buffer is recorded that is its submission, otherwise
+    // the next submission on any queue or a waitIdle
     void free(Window window) const;
     void free(Shader shader) const;
     void free(RenderPass renderPass) const;
     void free(Semaphore semaphore) const;
+    void free(Timeline timeline) const;
     void free(Fence fence) const;
     void free(CommandBuffer commandBuffer) const;
     void free(Buffer buffer) const;
@@ -82,12 +236,66 @@ class GraphicsDevice final {
     VkDevice m_device = VK_NULL_HANDLE;
 
   private:
-    VkInstance       m_instance       = VK_NULL_HANDLE;
-    VkPhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
+    template <typename T>
+    memory::HandlePool<T>& pool() const;
+    template <typename T>
+    T& get(memory::Handle<T> handle) const;
+    template <typename T>
+    void destroy(memory::Handle<T> handle) const;
+    template <typename T>
+    void retire(memory::Handle<T> handle) const;
+    void collectRetiredObjects(uint64_t completedValue) const;
+
+    // compute or transfer queue, used when the device has a dedicated family for it
+    struct AsyncQueue {
+        uint32_t      family         = VK_QUEUE_FAMILY_IGNORED; // ignored if there is neither a dedicated nor a fallback family
+        bool          isDedicated    = false;                   // false if the family is the fallback, transfer falls back to compute
+        uint32_t      queueIndex     = 0;
+        VkQueue       vkQueue        = VK_NULL_HANDLE;
+        VkCommandPool vkCommandPool  = VK_NULL_HANDLE;
+        Timeline      timeline;                                 // signaled with the submit value of each submission to the queue
+        uint64_t      submittedValue = 0;                       // of the latest submission to the queue
+    };
+
+    AsyncQueue* getAsyncQueue(QueueType queueType);
+
+    // region of the staging ring, see uploadBuffer
+    struct StagingChunk {
+        void*    data;
+        uint64_t size;
+        uint32_t slot;
+    };
+    struct StagingSlot {
+        CommandBuffer cmd;
+        TimelinePoint point; // of the latest upload from the slot
+    };
+
+    StagingChunk  acquireStagingChunk(uint64_t maxSize);
+    TimelinePoint submitStagingChunk(const StagingChunk& chunk, Buffer dst, uint64_t dstOffset);
+    // latest submit value whose submission and every earlier one have completed, on all queues
+    uint64_t    getCompletedSubmitValue() const;
+
+    // records the host mapped memory written since the last submission, see CaptureWriter
+    void captureMappedData();
+
+  private:
+    std::unique_ptr<HostAllocator> m_hostAllocator;         // destroyed after the instance
+    const VkAllocationCallbacks*   m_vkAllocator = nullptr; // of m_hostAllocator, passed to every create and destroy call
+
+    VkInstance                 m_instance                 = VK_NULL_HANDLE;
+    VkPhysicalDevice           m_physicalDevice           = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties m_physicalDeviceProperties = {};
+
+    bool                       m_isDynamicRenderingSupported = false;
+    bool                       m_isPipelineStatsSupported    = false; // pipeline statistics queries that bundles can inherit
+    PFN_vkCmdBeginRenderingKHR m_vkCmdBeginRendering         = nullptr;
+    PFN_vkCmdEndRenderingKHR   m_vkCmdEndRendering           = nullptr;
 
     VkQueue                              m_graphicsQueue = VK_NULL_HANDLE;
     std::vector<VkQueueFamilyProperties> m_queueFamilies;
     uint32_t                             m_graphicsFamily = VK_QUEUE_FAMILY_IGNORED;
+    std::array<AsyncQueue, 2>            m_asyncQueues;         // compute and transfer
+    std::vector<uint32_t>                m_bufferQueueFamilies; // distinct families of the queues, buffers are shared between them
 
     VkCommandPool    m_commandPool    = VK_NULL_HANDLE; // TODO: Support multiple command pools
     VkDescriptorPool m_descriptorPool = VK_NULL_HANDLE; // TODO: Support multiple and dynamic descriptor pool
@@ -96,10 +304,47 @@ class GraphicsDevice final {
 
     std::vector<CommandBuffer> m_commandBuffers;
     std::vector<Fence>         m_inFlightFences;
-    std::vector<Semaphore>     m_imageAvailableSemaphores;
-    std::vector<Semaphore>     m_renderFinishedSemaphores;
 
     uint32_t m_currentFrame = 0;
+    bool     m_isFrameBegun = false;
+
+    // windows acquired in the current frame
+    std::array<Window, MAX_FRAME_WINDOWS>   m_frameWindows;
+    std::array<uint32_t, MAX_FRAME_WINDOWS> m_frameImageIndices = {};
+    uint32_t                                m_frameWindowCount  = 0;
+
+    Timeline m_submitTimeline;           // signaled by every graphics submission
+    uint64_t m_submitValue         = 0;  // increased by every submission on any queue, drives deferred frees
+    uint64_t m_graphicsSubmitValue = 0;  // value signaled by the latest graphics submission
+    uint64_t m_pendingCopyValue    = 0;  // latest copy submission the next frame has to wait for
+    uint64_t m_pendingUploadValue  = 0;  // latest upload on the transfer queue the next frame has to wait for
+
+    FramePacer                    m_framePacer;
+    FrameTimingStats              m_frameTiming;     // of the current frame
+    FrameTimingStats              m_lastFrameTiming; // of the last presented frame
+    FramePacer::Clock::time_point m_inputSampleTime;
+    bool                          m_isInputSampled = false; // pollEvents was called since the last present
+
+    FrameStats m_frameStats;     // of the current frame
+    FrameStats m_lastFrameStats; // of the last presented frame
+
+    // queries of the frame command buffers, two timestamps and one pipeline statistics query per frame in flight
+    VkQueryPool       m_timestampQueryPool     = VK_NULL_HANDLE; // null if the graphics queue has no timestamps
+    VkQueryPool       m_pipelineStatsQueryPool = VK_NULL_HANDLE; // null without pipeline statistics support
+    uint64_t          m_timestampMask          = 0;              // valid bits of the timestamps
+    std::vector<bool> m_isFrameQueryWritten;                     // per frame in flight, submitted since the last read
+
+    Buffer   m_uniformRing;            // one region per frame in flight
+    uint64_t m_uniformRegionSize = 0;
+    uint64_t m_uniformOffset     = 0;  // next free byte in the region of the current frame
+    uint64_t m_uniformRegionEnd  = 0;
+
+    Buffer                   m_stagingRing;          // one chunk per slot
+    std::vector<StagingSlot> m_stagingSlots;
+    uint32_t                 m_stagingSlotIndex = 0; // next slot to write
+
+    std::unique_ptr<ObjectPools>   m_objects;
+    std::unique_ptr<CaptureWriter> m_capture; // null unless capturing
 };
 
 } // namespace oz::gfx::vk
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "oz/gfx/vulkan/host_allocator.h"
+
+namespace oz::gfx::vk {
+
+namespace {
+
+// in front of every block, the returned memory starts right after it
+struct BlockHeader {
+    uint64_t size;      // requested by the driver
+    uint32_t offset;    // from the start of the heap allocation, unused for arena blocks
+    uint8_t  scope;     // VkSystemAllocationScope the block is tracked in
+    uint8_t  sizeClass; // arena size class, NO_SIZE_CLASS for heap blocks
+    uint16_t padding;
+};
+static_assert(sizeof(BlockHeader) == 16);
+
+static constexpr uint8_t NO_SIZE_CLASS = 0xff;
+
+static std::atomic<uint64_t> s_nextAllocatorId = 1;
+
+BlockHeader* getHeader(void* memory) { return static_cast<BlockHeader*>(memory) - 1; }
+
+// smallest class whose blocks hold the header and the requested bytes, NO_SIZE_CLASS if it does not fit any
+uint8_t getSizeClass(size_t size) {
+    const size_t blockSize = size + sizeof(BlockHeader);
+    for (uint8_t sizeClass = 0; sizeClass < HostAllocator::SIZE_CLASS_COUNT; sizeClass++) {
+        if (blockSize <= (size_t(32) << sizeClass)) {
+            return sizeClass;
+        }
+    }
+    return NO_SIZE_CLASS;
+}
+
+} // namespace
+
+thread_local uint64_t              HostAllocator::t_allocatorId = 0;
+thread_local HostAllocator::Arena* HostAllocator::t_arena       = nullptr;
+
+HostAllocator::HostAllocator(bool isArenaEnabled) : m_isArenaEnabled(isArenaEnabled), m_id(s_nextAllocatorId++) {
+    m_callbacks.pUserData             = this;
+    m_callbacks.pfnAllocation         = &HostAllocator::allocate;
+    m_callbacks.pfnReallocation       = &HostAllocator::reallocate;
+    m_callbacks.pfnFree               = &HostAllocator::free;
+    m_callbacks.pfnInternalAllocation = &HostAllocator::notifyInternalAllocation;
+    m_callbacks.pfnInternalFree       = &HostAllocator::notifyInternalFree;
+}
+
+HostAllocator::~HostAllocator() {
+    for (const std::unique_ptr<Arena>& arena : m_arenas) {
+        for (void* chunk : arena->chunks) {
+            std::free(chunk);
+        }
+    }
+}
+
+HostMemoryStats HostAllocator::getStats() const {
+    HostMemoryStats stats;
+    for (uint32_t i = 0; i < SCOPE_COUNT; i++) {
+        stats.scopes[i].bytes            = m_scopes[i].bytes.load(std::memory_order_relaxed);
+        stats.scopes[i].peakBytes        = m_scopes[i].peakBytes.load(std::memory_order_relaxed);
+        stats.scopes[i].allocations      = m_scopes[i].allocations.load(std::memory_order_relaxed);
+        stats.scopes[i].totalAllocations = m_scopes[i].totalAllocations.load(std::memory_order_relaxed);
+        stats.scopes[i].internalBytes    = m_scopes[i].internalBytes.load(std::memory_order_relaxed);
+    }
+    stats.arenaBytes = m_arenaBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// callbacks
+
+void* HostAllocator::allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    if (size == 0) {
+        return nullptr;
+    }
+    return static_cast<HostAllocator*>(userData)->allocateBlock(size, alignment, scope);
+}
+
+void* HostAllocator::reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    HostAllocator* allocator = static_cast<HostAllocator*>(userData);
+    if (original == nullptr) {
+        return allocate(userData, size, alignment, scope);
+    }
+    if (size == 0) {
+        allocator->freeBlock(original);
+        return nullptr;
+    }
+
+    // the original is kept if the new block cannot be allocated
+    void* memory = allocator->allocateBlock(size, alignment, scope);
+    if (memory != nullptr) {
+        std::memcpy(memory, original, std::min<size_t>(size, getHeader(original)->size));
+        allocator->freeBlock(original);
+    }
+    return memory;
+}
+
+void HostAllocator::free(void* userData, void* memory) {
+    if (memory != nullptr) {
+        static_cast<HostAllocator*>(userData)->freeBlock(memory);
+    }
+}
+
+void HostAllocator::notifyInternalAllocation(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope) {
+    static_cast<HostAllocator*>(userData)->m_scopes[scope].internalBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void HostAllocator::notifyInternalFree(void* userData, size_t size, VkInternalAllocationType, VkSystemAllocationScope scope) {
+    static_cast<HostAllocator*>(userData)->m_scopes[scope].internalBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// blocks
+
+void* HostAllocator::allocateBlock(size_t size, size_t alignment, VkSystemAllocationScope scope) {
+    BlockHeader* header = nullptr;
+
+    // commands and objects are the allocations made while recording and creating on worker threads
+    const bool    isArenaScope = scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND || scope == VK_SYSTEM_ALLOCATION_SCOPE_OBJECT;
+    const uint8_t sizeClass    = m_isArenaEnabled && isArenaScope && alignment <= ARENA_ALIGNMENT ? getSizeClass(size) : NO_SIZE_CLASS;
+    if (sizeClass != NO_SIZE_CLASS) {
+        Arena&       arena     = getThreadArena();
+        const size_t blockSize = size_t(32) << sizeClass;
+
+        void* block = arena.freeLists[sizeClass];
+        if (block != nullptr) {
+            std::memcpy(&arena.freeLists[sizeClass], block, sizeof(void*));
+        } else {
+            if (arena.cursor == nullptr || static_cast<size_t>(arena.end - arena.cursor) < blockSize) {
+                uint8_t* chunk = static_cast<uint8_t*>(std::malloc(ARENA_CHUNK_SIZE));
+                if (chunk == nullptr) {
+                    return nullptr;
+                }
+                arena.chunks.push_back(chunk);
+                arena.cursor = chunk;
+                arena.end    = chunk + ARENA_CHUNK_SIZE;
+                m_arenaBytes.fetch_add(ARENA_CHUNK_SIZE, std::memory_order_relaxed);
+            }
+            block = arena.cursor;
+            arena.cursor += blockSize;
+        }
+
+        header         = static_cast<BlockHeader*>(block);
+        header->offset = 0;
+    } else {
+        // over-allocated so the block can be aligned with the header in front of it
+        alignment          = std::max(alignment, alignof(std::max_align_t));
+        uint8_t* allocated = static_cast<uint8_t*>(std::malloc(size + alignment + sizeof(BlockHeader)));
+        if (allocated == nullptr) {
+            return nullptr;
+        }
+        const uintptr_t start   = reinterpret_cast<uintptr_t>(allocated);
+        const uintptr_t address = (start + sizeof(BlockHeader) + alignment - 1) & ~(uintptr_t(alignment) - 1);
+        uint8_t*        memory  = allocated + (address - start);
+
+        header         = getHeader(memory);
+        header->offset = static_cast<uint32_t>(memory - allocated);
+    }
+    header->size      = size;
+    header->scope     = static_cast<uint8_t>(scope);
+    header->sizeClass = sizeClass;
+
+    ScopeCounters& counters = m_scopes[scope];
+    const uint64_t bytes    = counters.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t       peak     = counters.peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peak && !counters.peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+    }
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    return header + 1;
+}
+
+void HostAllocator::freeBlock(void* memory) {
+    BlockHeader*   header   = getHeader(memory);
+    ScopeCounters& counters = m_scopes[header->scope];
+    counters.bytes.fetch_sub(header->size, std::memory_order_relaxed);
+    counters.allocations.fetch_sub(1, std::memory_order_relaxed);
+
+    if (header->sizeClass != NO_SIZE_CLASS) {
+        // joins the free list of the freeing thread, which may not be the one that allocated it
+        Arena& arena = getThreadArena();
+        void*  block = header;
+        std::memcpy(block, &arena.freeLists[header->sizeClass], sizeof(void*));
+        arena.freeLists[header->sizeClass] = block;
+    } else {
+        std::free(static_cast<uint8_t*>(memory) - header->offset);
+    }
+}
+
+HostAllocator::Arena& HostAllocator::getThreadArena() {
+    if (t_allocatorId == m_id) {
+        return *t_arena;
+    }
+
+    // first use on this thread or another allocator was used in between
+    std::lock_guard<std::mutex> lock(m_arenaMutex);
+    const std::thread::id thread = std::this_thread::get_id();
+
+    Arena* arena = nullptr;
+    for (const std::unique_ptr<Arena>& candidate : m_arenas) {
+        if (candidate->thread == thread) {
+            arena = candidate.get();
+            break;
+        }
+    }
+    if (arena == nullptr) {
+        arena         = m_arenas.emplace_back(std::make_unique<Arena>()).get();
+        arena->thread = thread;
+    }
+
+    t_allocatorId = m_id;
+    t_arena       = arena;
+    return *arena;
+}
+
+} // namespace oz::gfx::vk
\ No newline at end of file
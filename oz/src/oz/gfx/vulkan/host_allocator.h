@@ -0,0 +1,75 @@
+#pragma once
+
+#include "oz/gfx/vulkan/common.h"
+#include "oz/gfx/vulkan/stats.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace oz::gfx::vk {
+
+// Host memory of the Vulkan driver, its callbacks are passed to every create and destroy call of the device.
+// Allocations are tracked per VkSystemAllocationScope. With arenas, small command and object scoped allocations are
+// served from size class free lists of the calling thread, so threads recording commands do not contend on the heap.
+// Arena blocks freed on another thread join the free lists of that thread, arena memory is released with the allocator.
+class HostAllocator final {
+  public:
+    static constexpr uint32_t SCOPE_COUNT      = VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+    static constexpr uint32_t SIZE_CLASS_COUNT = 8;         // blocks of 32 bytes to 4 KiB, header included
+    static constexpr size_t   ARENA_CHUNK_SIZE = 64 * 1024; // carved into blocks on demand
+    static constexpr size_t   ARENA_ALIGNMENT  = 16;        // larger alignments go to the heap
+
+    explicit HostAllocator(bool isArenaEnabled);
+    ~HostAllocator();
+
+    HostAllocator(const HostAllocator&)            = delete;
+    HostAllocator& operator=(const HostAllocator&) = delete;
+
+    const VkAllocationCallbacks* getCallbacks() const { return &m_callbacks; }
+    HostMemoryStats              getStats() const;
+
+  private:
+    struct Arena {
+        std::thread::id                     thread;
+        std::array<void*, SIZE_CLASS_COUNT> freeLists = {};      // freed blocks, linked through their first bytes
+        std::vector<void*>                  chunks;
+        uint8_t*                            cursor    = nullptr; // next unused byte of the last chunk
+        uint8_t*                            end       = nullptr;
+    };
+
+    struct ScopeCounters {
+        std::atomic<uint64_t> bytes            = 0;
+        std::atomic<uint64_t> peakBytes        = 0;
+        std::atomic<uint64_t> allocations      = 0;
+        std::atomic<uint64_t> totalAllocations = 0;
+        std::atomic<uint64_t> internalBytes    = 0;
+    };
+
+    static void* VKAPI_CALL allocate(void* userData, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static void* VKAPI_CALL reallocate(void* userData, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static void VKAPI_CALL  free(void* userData, void* memory);
+    static void VKAPI_CALL  notifyInternalAllocation(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+    static void VKAPI_CALL  notifyInternalFree(void* userData, size_t size, VkInternalAllocationType type, VkSystemAllocationScope scope);
+
+    void*  allocateBlock(size_t size, size_t alignment, VkSystemAllocationScope scope);
+    void   freeBlock(void* memory);
+    Arena& getThreadArena();
+
+    // arena of the current thread for the allocator that used it last
+    static thread_local uint64_t t_allocatorId;
+    static thread_local Arena*   t_arena;
+
+  private:
+    VkAllocationCallbacks m_callbacks      = {};
+    bool                  m_isArenaEnabled = false;
+    uint64_t              m_id             = 0; // identifies the allocator in the arena lookup of a thread
+
+    std::array<ScopeCounters, SCOPE_COUNT> m_scopes;
+    std::atomic<uint64_t>                  m_arenaBytes = 0;
+
+    std::mutex                          m_arenaMutex;
+    std::vector<std::unique_ptr<Arena>> m_arenas; // one per thread that allocated through an arena
+};
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -1,16 +1,20 @@
 #pragma once
 
+#include "oz/core/memory/handle_pool.h"
 #include "oz/gfx/vulkan/common.h"
 
 namespace oz::gfx::vk {
 
-#define OZ_VK_OBJECT(NAME) typedef struct NAME##Object* NAME;
+#define OZ_VK_OBJECT(NAME) \
+    struct NAME##Object;   \
+    typedef memory::Handle<NAME##Object> NAME;
 
 OZ_VK_OBJECT(Window);
 OZ_VK_OBJECT(Shader);
 OZ_VK_OBJECT(RenderPass);
 OZ_VK_OBJECT(Fence);
 OZ_VK_OBJECT(Semaphore);
+OZ_VK_OBJECT(Timeline);
 OZ_VK_OBJECT(CommandBuffer);
 OZ_VK_OBJECT(Buffer);
 OZ_VK_OBJECT(DescriptorSetLayout);
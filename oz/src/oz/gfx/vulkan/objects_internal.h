@@ -1,54 +1,67 @@
 #pragma once
 
+#include "oz/core/memory/handle_pool.h"
 #include "oz/gfx/vulkan/common.h"
+#include "oz/gfx/vulkan/deletion_queue.h"
+#include "oz/gfx/vulkan/pipeline_cache.h"
+#include "oz/gfx/vulkan/property_structs.h"
+#include "oz/gfx/vulkan/stats.h"
 
 namespace oz::gfx::vk {
 
-struct IObject {
-    virtual ~IObject()                   = default;
-    virtual void free(VkDevice vkDevice) = 0;
-};
-
-struct ShaderObject final : IObject {
+struct ShaderObject final {
     ShaderStage stage;
 
     VkShaderModule                  vkShaderModule                  = VK_NULL_HANDLE;
-    VkPipelineShaderStageCreateInfo vkPipelineShaderStageCreateInfo = {};
+    VkPipelineShaderStageCreateInfo vkPipelineShaderStageCreateInfo = {}; // pSpecializationInfo is filled per pipeline
+    uint64_t                        codeHash                        = 0;  // of the SPIR-V, identifies the shader in pipeline keys
+    SpecializationConstants         specialization;                       // defaults, overridden by the ones of the pipeline
 
-    void free(VkDevice vkDevice) override { vkDestroyShaderModule(vkDevice, vkShaderModule, nullptr); }
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) { vkDestroyShaderModule(vkDevice, vkShaderModule, vkAllocator); }
 };
 
-struct RenderPassObject final : IObject {
+struct RenderPassObject final {
     VkRenderPass               vkRenderPass       = VK_NULL_HANDLE;
     VkPipelineLayout           vkPipelineLayout   = VK_NULL_HANDLE;
     VkPipeline                 vkGraphicsPipeline = VK_NULL_HANDLE;
     VkExtent2D                 vkExtent           = {};
     std::vector<VkFramebuffer> vkFrameBuffers;
+    std::vector<VkFormat>      vkColorFormats; // dynamic rendering only, vkRenderPass and vkFrameBuffers are empty then
 
-    void free(VkDevice vkDevice) override {
-        vkDestroyPipeline(vkDevice, vkGraphicsPipeline, nullptr);
-        vkDestroyPipelineLayout(vkDevice, vkPipelineLayout, nullptr);
-        vkDestroyRenderPass(vkDevice, vkRenderPass, nullptr);
+    uint64_t       pipelineKey   = 0;
+    PipelineCache* pipelineCache = nullptr; // referenced to used on free, owns vkGraphicsPipeline
+
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) {
+        pipelineCache->release(vkDevice, pipelineKey);
+        vkDestroyPipelineLayout(vkDevice, vkPipelineLayout, vkAllocator);
+        vkDestroyRenderPass(vkDevice, vkRenderPass, vkAllocator);
 
         for (auto framebuffer : vkFrameBuffers) {
-            vkDestroyFramebuffer(vkDevice, framebuffer, nullptr);
+            vkDestroyFramebuffer(vkDevice, framebuffer, vkAllocator);
         }
     }
 };
 
-struct SemaphoreObject final : IObject {
+struct SemaphoreObject final {
     VkSemaphore vkSemaphore = VK_NULL_HANDLE;
     // TODO: only vkSemaphore is supported
-    void free(VkDevice vkDevice) override { vkDestroySemaphore(vkDevice, vkSemaphore, nullptr); }
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) { vkDestroySemaphore(vkDevice, vkSemaphore, vkAllocator); }
+};
+
+struct TimelineObject final {
+    VkSemaphore vkSemaphore    = VK_NULL_HANDLE;
+    uint64_t    completedValue = 0; // last value observed on the host, used to skip counter queries
+
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) { vkDestroySemaphore(vkDevice, vkSemaphore, vkAllocator); }
 };
 
-struct FenceObject final : IObject {
+struct FenceObject final {
     VkFence vkFence = VK_NULL_HANDLE;
     // TODO: only vkFence is supported
-    void free(VkDevice vkDevice) override { vkDestroyFence(vkDevice, vkFence, nullptr); }
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) { vkDestroyFence(vkDevice, vkFence, vkAllocator); }
 };
 
-struct WindowObject final : IObject {
+struct WindowObject final {
     GLFWwindow*  vkWindow  = nullptr;
     VkSurfaceKHR vkSurface = VK_NULL_HANDLE;
 
@@ -60,15 +73,27 @@ struct WindowObject final : IObject {
 
     VkQueue vkPresentQueue = VK_NULL_HANDLE;
 
+    // per frame in flight, so several windows can be acquired and presented in the same frame
+    std::vector<VkSemaphore> vkImageAvailableSemaphores;
+    std::vector<VkSemaphore> vkRenderFinishedSemaphores;
+
     VkInstance vkInstance = VK_NULL_HANDLE; // referenced to used on free
 
-    void free(VkDevice vkDevice) override {
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) {
+        // semaphores
+        for (auto semaphore : vkImageAvailableSemaphores) {
+            vkDestroySemaphore(vkDevice, semaphore, vkAllocator);
+        }
+        for (auto semaphore : vkRenderFinishedSemaphores) {
+            vkDestroySemaphore(vkDevice, semaphore, vkAllocator);
+        }
+
         // swap chain
-        vkDestroySwapchainKHR(vkDevice, vkSwapChain, nullptr);
+        vkDestroySwapchainKHR(vkDevice, vkSwapChain, vkAllocator);
 
         // image views
         for (auto imageView : vkSwapChainImageViews) {
-            vkDestroyImageView(vkDevice, imageView, nullptr);
+            vkDestroyImageView(vkDevice, imageView, vkAllocator);
         }
 
         // images
@@ -78,7 +103,7 @@ struct WindowObject final : IObject {
 
         // surface
         if (vkSurface != VK_NULL_HANDLE) {
-            vkDestroySurfaceKHR(vkInstance, vkSurface, nullptr);
+            vkDestroySurfaceKHR(vkInstance, vkSurface, vkAllocator);
         }
 
         // window
@@ -88,47 +113,150 @@ struct WindowObject final : IObject {
     }
 };
 
-struct CommandBufferObject final : IObject {
+static constexpr uint32_t MAX_BOUND_DESCRIPTOR_SETS = 8;
+static constexpr uint32_t MAX_RENDERING_ATTACHMENTS = 8;
+
+struct CommandBufferObject final {
     VkCommandBuffer vkCommandBuffer = VK_NULL_HANDLE;
+    VkCommandPool   vkCommandPool   = VK_NULL_HANDLE; // referenced to used on free
+    QueueType       queueType       = QueueType::Graphics; // queue the command buffer is submitted to
+    bool            isSubmitPending = false; // begun and not submitted yet
+
+    // currently bound state, used to skip redundant binds
+    // reset on beginCmd
+    VkPipeline                                             vkBoundPipeline       = VK_NULL_HANDLE;
+    VkPipelineLayout                                       vkBoundPipelineLayout = VK_NULL_HANDLE;
+    VkExtent2D                                             vkBoundExtent         = {};
+    VkBuffer                                               vkBoundVertexBuffer   = VK_NULL_HANDLE;
+    VkBuffer                                               vkBoundIndexBuffer    = VK_NULL_HANDLE;
+    VkIndexType                                            vkBoundIndexType      = VK_INDEX_TYPE_UINT16;
+    std::array<VkDescriptorSet, MAX_BOUND_DESCRIPTOR_SETS> vkBoundDescriptorSets = {};
+
+    CommandStats stats;
+
+    // images and area of the current beginRendering, transitioned for presentation by endRendering
+    std::array<VkImage, MAX_RENDERING_ATTACHMENTS> vkRenderingImages   = {};
+    uint32_t                                       renderingImageCount = 0;
+    VkExtent2D                                     vkRenderingExtent   = {};
+
+    // readback destinations recorded since beginCmd, they complete with the next submission
+    std::vector<Buffer> readbacks;
+    // bundles executed since beginCmd, their recordings are in use until the next submission has completed
+    std::vector<CommandBuffer> executedBundles;
 
-    void free(VkDevice vkDevice) override {}
+    // bundles only, see GraphicsDevice::beginBundle
+    bool          isBundle           = false;
+    bool          isRecorded         = false;
+    uint32_t      pendingExecutions  = 0; // executed into command buffers that are not submitted yet
+    TimelinePoint executedPoint;          // latest submission that executed the recording
+    uint64_t      recordedVersion    = 0;
+    RenderPass    recordedRenderPass;
+
+    // bound state is unknown after executing secondary command buffers, stats are kept
+    void invalidateBoundState() {
+        vkBoundPipeline       = VK_NULL_HANDLE;
+        vkBoundPipelineLayout = VK_NULL_HANDLE;
+        vkBoundExtent         = {};
+        vkBoundVertexBuffer   = VK_NULL_HANDLE;
+        vkBoundIndexBuffer    = VK_NULL_HANDLE;
+        vkBoundIndexType      = VK_INDEX_TYPE_UINT16;
+        vkBoundDescriptorSets = {};
+    }
+
+    void resetBoundState() {
+        invalidateBoundState();
+        renderingImageCount = 0;
+        vkRenderingExtent   = {};
+        stats               = {};
+    }
+
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) {
+        if (vkCommandBuffer != VK_NULL_HANDLE) {
+            vkFreeCommandBuffers(vkDevice, vkCommandPool, 1, &vkCommandBuffer);
+        }
+    }
 };
 
-struct BufferObject final : IObject {
+struct BufferObject final {
     VkBuffer       vkBuffer = VK_NULL_HANDLE;
     VkDeviceMemory vkMemory = VK_NULL_HANDLE;
+    uint64_t       size     = 0;
     void*          data     = nullptr;
 
-    void free(VkDevice vkDevice) override {
-        vkDestroyBuffer(vkDevice, vkBuffer, nullptr);
-        vkFreeMemory(vkDevice, vkMemory, nullptr);
+    // readback buffers only, see GraphicsDevice::readBuffer
+    bool          isHostCoherent    = true;
+    bool          isReadbackIssued  = false; // readBuffer was recorded into the buffer at least once
+    bool          isReadbackPending = false; // recorded, the point is known once the command buffer is submitted
+    TimelinePoint readbackPoint;
+
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) {
+        vkDestroyBuffer(vkDevice, vkBuffer, vkAllocator);
+        vkFreeMemory(vkDevice, vkMemory, vkAllocator);
         data = nullptr;
     }
 };
 
-struct DescriptorSetLayoutObject final : IObject {
-    VkDescriptorSetLayout vkDescriptorSetLayout = VK_NULL_HANDLE;
+struct DescriptorSetLayoutObject final {
+    VkDescriptorSetLayout                                               vkDescriptorSetLayout = VK_NULL_HANDLE;
+    memory::InlineVector<VkDescriptorType, MAX_DESCRIPTOR_SET_BINDINGS> vkDescriptorTypes; // per binding, used to write the sets
 
-    void free(VkDevice vkDevice) override { vkDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout, nullptr); }
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) {
+        vkDestroyDescriptorSetLayout(vkDevice, vkDescriptorSetLayout, vkAllocator);
+    }
 };
 
-struct DescriptorSetObject final : IObject {
-    VkDescriptorSet vkDescriptorSet = VK_NULL_HANDLE;
-    VkDescriptorPool vkDescriptorPool = VK_NULL_HANDLE;
-    void free(VkDevice vkDevice) override {
+struct DescriptorSetObject final {
+    VkDescriptorSet  vkDescriptorSet  = VK_NULL_HANDLE;
+    VkDescriptorPool vkDescriptorPool = VK_NULL_HANDLE; // referenced to used on free
+
+    void free(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) {
         if (vkDescriptorSet != VK_NULL_HANDLE) {
             vkFreeDescriptorSets(vkDevice, vkDescriptorPool, 1, &vkDescriptorSet);
         }
     }
 };
 
-#define OZ_CREATE_VK_OBJECT(TYPE) new TYPE##Object
+// per-type object storage, see memory::HandlePool and DeletionQueue
+struct ObjectPools final {
+    explicit ObjectPools(const ObjectCapacityInfo& capacities)
+        : pools(capacities.windows,
+                capacities.shaders,
+                capacities.renderPasses,
+                capacities.semaphores,
+                capacities.timelines,
+                capacities.fences,
+                capacities.commandBuffers,
+                capacities.buffers,
+                capacities.descriptorSetLayouts,
+                capacities.descriptorSets) {}
+
+    std::tuple<memory::HandlePool<WindowObject>,
+               memory::HandlePool<ShaderObject>,
+               memory::HandlePool<RenderPassObject>,
+               memory::HandlePool<SemaphoreObject>,
+               memory::HandlePool<TimelineObject>,
+               memory::HandlePool<FenceObject>,
+               memory::HandlePool<CommandBufferObject>,
+               memory::HandlePool<BufferObject>,
+               memory::HandlePool<DescriptorSetLayoutObject>,
+               memory::HandlePool<DescriptorSetObject>>
+        pools;
+
+    DeletionQueue<WindowObject,
+                  ShaderObject,
+                  RenderPassObject,
+                  SemaphoreObject,
+                  TimelineObject,
+                  FenceObject,
+                  CommandBufferObject,
+                  BufferObject,
+                  DescriptorSetLayoutObject,
+                  DescriptorSetObject>
+        deletionQueue;
+
+    PipelineCache pipelineCache;
+};
 
-#define OZ_FREE_VK_OBJECT(vkDevice, vkObject) \
-    if (vkObject) {                           \
-        vkObject->free(vkDevice);             \
-        delete vkObject;                      \
-        vkObject = nullptr;                   \
-    } //\
+#define OZ_CREATE_VK_OBJECT(TYPE) pool<TYPE##Object>().create()
 
-} // namespace oz::gfx::vk 
\ No newline at end of file
+} // namespace oz::gfx::vk
\ No newline at end of file
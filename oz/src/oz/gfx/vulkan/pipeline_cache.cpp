@@ -0,0 +1,53 @@
+#include "oz/gfx/vulkan/pipeline_cache.h"
+
+namespace oz::gfx::vk {
+
+#define OZ_VK_ASSERT(result) assert(result == VK_SUCCESS)
+
+void PipelineCache::init(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator) {
+    m_vkAllocator = vkAllocator;
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = 0;
+    createInfo.pInitialData    = nullptr;
+
+    OZ_VK_ASSERT(vkCreatePipelineCache(vkDevice, &createInfo, m_vkAllocator, &m_vkPipelineCache));
+}
+
+void PipelineCache::free(VkDevice vkDevice) {
+    for (auto& [key, entry] : m_entries) {
+        vkDestroyPipeline(vkDevice, entry.vkPipeline, m_vkAllocator);
+    }
+    m_entries.clear();
+
+    vkDestroyPipelineCache(vkDevice, m_vkPipelineCache, m_vkAllocator);
+    m_vkPipelineCache = VK_NULL_HANDLE;
+}
+
+VkPipeline PipelineCache::acquire(uint64_t key) {
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return VK_NULL_HANDLE;
+    }
+
+    it->second.refCount++;
+    return it->second.vkPipeline;
+}
+
+void PipelineCache::insert(uint64_t key, VkPipeline vkPipeline) {
+    assert(m_entries.find(key) == m_entries.end()); // acquire has to miss first
+    m_entries[key] = {vkPipeline, 1};
+}
+
+void PipelineCache::release(VkDevice vkDevice, uint64_t key) {
+    auto it = m_entries.find(key);
+    assert(it != m_entries.end());
+
+    if (--it->second.refCount == 0) {
+        vkDestroyPipeline(vkDevice, it->second.vkPipeline, m_vkAllocator);
+        m_entries.erase(it);
+    }
+}
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "oz/gfx/vulkan/common.h"
+
+#include <unordered_map>
+
+namespace oz::gfx::vk {
+
+// Shares graphics pipelines between render passes created from the same state.
+// The key covers the shader modules, the specialization constants, the vertex layout, the descriptor set layouts and
+// the attachment formats, so every shader variant gets its own entry. Misses are compiled through a VkPipelineCache.
+class PipelineCache final {
+  public:
+    // the allocation callbacks are used for the cache and its pipelines
+    void init(VkDevice vkDevice, const VkAllocationCallbacks* vkAllocator);
+    void free(VkDevice vkDevice); // also destroys the pipelines that are still referenced
+
+    // adds a reference to the pipeline of the key, VK_NULL_HANDLE if there is none yet
+    VkPipeline acquire(uint64_t key);
+    // takes over a newly created pipeline with a single reference
+    void       insert(uint64_t key, VkPipeline vkPipeline);
+    // destroys the pipeline once its last reference is released
+    void       release(VkDevice vkDevice, uint64_t key);
+
+    VkPipelineCache getVkPipelineCache() const { return m_vkPipelineCache; }
+    uint32_t        size() const { return static_cast<uint32_t>(m_entries.size()); }
+
+  private:
+    struct Entry {
+        VkPipeline vkPipeline = VK_NULL_HANDLE;
+        uint32_t   refCount   = 0;
+    };
+
+    VkPipelineCache                     m_vkPipelineCache = VK_NULL_HANDLE;
+    const VkAllocationCallbacks*        m_vkAllocator     = nullptr;
+    std::unordered_map<uint64_t, Entry> m_entries;
+};
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "oz/core/memory/inline_vector.h"
 #include "oz/gfx/vulkan/common.h"
 #include "oz/gfx/vulkan/enums.h"
 
@@ -11,6 +12,73 @@ namespace oz::gfx::vk {
         return *this;                           \
     }
 
+// Device Info
+
+// overrides the scored physical device selection, the index is the enumeration order printed at startup
+struct DeviceSelectionInfo {
+    std::string             name;  // picks the best device whose name contains it
+    std::optional<uint32_t> index; // takes precedence over the name
+
+    OZ_CHAINED_SETTER(setName, std::string, name)
+    OZ_CHAINED_SETTER(setIndex, std::optional<uint32_t>, index)
+};
+
+// Capture Info
+
+// records the device calls of the first frames into a file for oz_replay, disabled while the path is empty
+struct CaptureInfo {
+    std::string path;
+    uint32_t    frameCount = 1;
+
+    OZ_CHAINED_SETTER(setPath, std::string, path)
+    OZ_CHAINED_SETTER(setFrameCount, uint32_t, frameCount)
+};
+
+// Host Allocator Info
+
+// host memory of the driver, tracked per allocation scope while enabled, see GraphicsDevice::getHostMemoryStats
+struct HostAllocatorInfo {
+    bool isEnabled      = true;
+    bool isArenaEnabled = false; // small command and object scoped allocations come from thread-local arenas
+
+    OZ_CHAINED_SETTER(setEnabled, bool, isEnabled)
+    OZ_CHAINED_SETTER(setArenaEnabled, bool, isArenaEnabled)
+};
+
+// Object Capacity Info
+
+// live objects per type, the pools are allocated up front and creating beyond a capacity throws
+// freed objects hold their slot until the GPU work that might reference them has completed
+// render passes, descriptor sets and buffers are limited by the RenderQueue key fields to 4096, 65536 and 65536
+struct ObjectCapacityInfo {
+    uint32_t windows              = 16;
+    uint32_t shaders              = 256;
+    uint32_t renderPasses         = 256;
+    uint32_t semaphores           = 256;
+    uint32_t timelines            = 64;
+    uint32_t fences               = 256;
+    uint32_t commandBuffers       = 1024;
+    uint32_t buffers              = 4096;
+    uint32_t descriptorSetLayouts = 256;
+    uint32_t descriptorSets       = 1024;
+
+    OZ_CHAINED_SETTER(setWindows, uint32_t, windows)
+    OZ_CHAINED_SETTER(setShaders, uint32_t, shaders)
+    OZ_CHAINED_SETTER(setRenderPasses, uint32_t, renderPasses)
+    OZ_CHAINED_SETTER(setSemaphores, uint32_t, semaphores)
+    OZ_CHAINED_SETTER(setTimelines, uint32_t, timelines)
+    OZ_CHAINED_SETTER(setFences, uint32_t, fences)
+    OZ_CHAINED_SETTER(setCommandBuffers, uint32_t, commandBuffers)
+    OZ_CHAINED_SETTER(setBuffers, uint32_t, buffers)
+    OZ_CHAINED_SETTER(setDescriptorSetLayouts, uint32_t, descriptorSetLayouts)
+    OZ_CHAINED_SETTER(setDescriptorSets, uint32_t, descriptorSets)
+};
+
+// layout infos are stored inline, so building and passing them does not allocate
+// constructing one with more attributes or bindings than these limits throws
+static constexpr uint32_t MAX_VERTEX_ATTRIBUTES       = 16; // guaranteed maxVertexInputAttributes
+static constexpr uint32_t MAX_DESCRIPTOR_SET_BINDINGS = 16;
+
 // Vertex Info
 
 struct VertexLayoutAttributeInfo final {
@@ -21,10 +89,12 @@ struct VertexLayoutAttributeInfo final {
 };
 
 struct VertexLayoutInfo final {
-    uint32_t                               vertexSize;
-    std::vector<VertexLayoutAttributeInfo> vertexLayoutAttributes;
+    uint32_t                                                               vertexSize;
+    memory::InlineVector<VertexLayoutAttributeInfo, MAX_VERTEX_ATTRIBUTES> vertexLayoutAttributes; // up to MAX_VERTEX_ATTRIBUTES
 
-    VertexLayoutInfo(uint32_t _vertexSize, std::vector<VertexLayoutAttributeInfo> const& _vertexLayoutAttributes)
+    VertexLayoutInfo(uint32_t _vertexSize, std::initializer_list<VertexLayoutAttributeInfo> _vertexLayoutAttributes)
+        : vertexSize(_vertexSize), vertexLayoutAttributes(_vertexLayoutAttributes) {}
+    VertexLayoutInfo(uint32_t _vertexSize, std::span<const VertexLayoutAttributeInfo> _vertexLayoutAttributes)
         : vertexSize(_vertexSize), vertexLayoutAttributes(_vertexLayoutAttributes) {}
 };
 
@@ -37,9 +107,10 @@ struct DescriptorSetLayoutBindingInfo {
 };
 
 struct DescriptorSetLayoutInfo {
-    std::vector<DescriptorSetLayoutBindingInfo> bindings;
+    memory::InlineVector<DescriptorSetLayoutBindingInfo, MAX_DESCRIPTOR_SET_BINDINGS> bindings; // up to MAX_DESCRIPTOR_SET_BINDINGS
 
-    DescriptorSetLayoutInfo(std::vector<DescriptorSetLayoutBindingInfo> const& _bindings) : bindings(_bindings) {}
+    DescriptorSetLayoutInfo(std::initializer_list<DescriptorSetLayoutBindingInfo> _bindings) : bindings(_bindings) {}
+    DescriptorSetLayoutInfo(std::span<const DescriptorSetLayoutBindingInfo> _bindings) : bindings(_bindings) {}
 };
 
 // Descriptor Set Info
@@ -58,9 +129,80 @@ struct DescriptorSetBindingInfo {
 };
 
 struct DescriptorSetInfo {
-    std::vector<DescriptorSetBindingInfo> bindings;
+    memory::InlineVector<DescriptorSetBindingInfo, MAX_DESCRIPTOR_SET_BINDINGS> bindings; // up to MAX_DESCRIPTOR_SET_BINDINGS
+
+    DescriptorSetInfo(std::initializer_list<DescriptorSetBindingInfo> _bindings) : bindings(_bindings) {}
+    DescriptorSetInfo(std::span<const DescriptorSetBindingInfo> _bindings) : bindings(_bindings) {}
+};
+
+// Specialization Info
+
+// typed specialization constants, matched by constant_id in the shader, e.g. layout(constant_id = 0) const bool USE_FOG = false;
+struct SpecializationConstants {
+    struct Entry {
+        uint32_t constantId;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    std::vector<Entry>   entries;
+    std::vector<uint8_t> data;
+
+    // bool is stored as a 32-bit VkBool32, a constant that is set again is overwritten
+    template <typename T>
+    SpecializationConstants& set(uint32_t constantId, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Specialization constants have to be trivially copyable!");
+
+        if constexpr (std::is_same_v<T, bool>) {
+            return set<uint32_t>(constantId, value ? 1u : 0u);
+        } else {
+            for (const Entry& entry : entries) {
+                if (entry.constantId == constantId) {
+                    assert(entry.size == sizeof(T)); // the type of a constant can not change
+                    std::memcpy(data.data() + entry.offset, &value, sizeof(T));
+                    return *this;
+                }
+            }
+
+            uint32_t offset = static_cast<uint32_t>(data.size());
+            entries.push_back({constantId, offset, static_cast<uint32_t>(sizeof(T))});
+            data.resize(offset + sizeof(T));
+            std::memcpy(data.data() + offset, &value, sizeof(T));
+            return *this;
+        }
+    }
+
+    bool empty() const { return entries.empty(); }
+};
+
+// Rendering Info
+
+struct RenderingAttachment {
+    Window    window;
+    uint32_t  imageIndex = 0; // from getCurrentImage
+    bool      clear      = true;
+    glm::vec4 clearColor = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+    RenderingAttachment(Window _window, uint32_t _imageIndex) : window(_window), imageIndex(_imageIndex) {}
+
+    OZ_CHAINED_SETTER(setClear, bool, clear)
+    OZ_CHAINED_SETTER(setClearColor, glm::vec4, clearColor)
+};
+
+// Uniform Info
+
+struct UniformAllocation {
+    void*    data   = nullptr; // mapped memory, written by the host
+    uint32_t offset = 0;       // dynamic offset in the uniform ring
+};
+
+// Sync Info
+
+struct TimelinePoint {
+    Timeline timeline;
+    uint64_t value;
 
-    DescriptorSetInfo(std::vector<DescriptorSetBindingInfo> const& _bindings) : bindings(_bindings) {}
+    TimelinePoint(Timeline _timeline = {}, uint64_t _value = 0) : timeline(_timeline), value(_value) {}
 };
 
 }; // namespace oz::gfx::vk
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "oz/gfx/vulkan/render_queue.h"
+
+#include "oz/gfx/vulkan/graphics_device.h"
+
+namespace oz::gfx::vk {
+
+namespace {
+
+static constexpr uint32_t RADIX_BITS    = 8;
+static constexpr uint32_t RADIX_BUCKETS = 1 << RADIX_BITS;
+static constexpr uint32_t RADIX_PASSES  = 64 / RADIX_BITS;
+
+// out of range values are masked, so they alias within their own field instead of spilling into the neighboring ones
+static uint64_t packField(uint32_t value, uint32_t bits) {
+    assert(value < (1u << bits));
+    return value & ((1u << bits) - 1);
+}
+
+template <typename T>
+static uint64_t packHandle(memory::Handle<T> handle, uint32_t bits) {
+    return handle ? packField(handle.index(), bits) : 0;
+}
+
+} // namespace
+
+uint64_t RenderQueue::makeKey(uint32_t pass, RenderPass pipeline, DescriptorSet material, Buffer mesh, float depth) {
+    float    clampedDepth = std::clamp(depth, 0.0f, 1.0f);
+    uint64_t depthBits    = static_cast<uint64_t>(clampedDepth * static_cast<float>((1u << DEPTH_BITS) - 1));
+
+    uint64_t key = packField(pass, PASS_BITS);
+    key          = (key << PIPELINE_BITS) | packHandle(pipeline, PIPELINE_BITS);
+    key          = (key << MATERIAL_BITS) | packHandle(material, MATERIAL_BITS);
+    key          = (key << MESH_BITS) | packHandle(mesh, MESH_BITS);
+    key          = (key << DEPTH_BITS) | depthBits;
+
+    return key;
+}
+
+RenderQueue::RenderQueue(uint32_t capacity) {
+    m_packets.reserve(capacity);
+    m_keys.reserve(capacity);
+    m_order.reserve(capacity);
+    m_scratchKeys.reserve(capacity);
+    m_scratchOrder.reserve(capacity);
+}
+
+void RenderQueue::push(uint64_t key, const DrawPacket& packet) {
+    m_order.push_back(static_cast<uint32_t>(m_packets.size()));
+    m_keys.push_back(key);
+    m_packets.push_back(packet);
+}
+
+void RenderQueue::push(uint32_t pass, float depth, const DrawPacket& packet) {
+    push(makeKey(pass, packet.pipeline, packet.material, packet.vertexBuffer, depth), packet);
+}
+
+void RenderQueue::clear() {
+    m_packets.clear();
+    m_keys.clear();
+    m_order.clear();
+}
+
+void RenderQueue::sort() {
+    const size_t count = m_keys.size();
+    if (count < 2) {
+        return;
+    }
+
+    m_scratchKeys.resize(count);
+    m_scratchOrder.resize(count);
+
+    // histograms of every digit in a single read of the keys
+    uint32_t histograms[RADIX_PASSES][RADIX_BUCKETS] = {};
+    for (uint64_t key : m_keys) {
+        for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+            histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    uint64_t* srcKeys  = m_keys.data();
+    uint32_t* srcOrder = m_order.data();
+    uint64_t* dstKeys  = m_scratchKeys.data();
+    uint32_t* dstOrder = m_scratchOrder.data();
+
+    for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+        uint32_t* histogram = histograms[pass];
+        uint32_t  shift     = pass * RADIX_BITS;
+
+        // a digit shared by every key does not change the order, unused key fields cost nothing this way
+        if (histogram[(srcKeys[0] >> shift) & (RADIX_BUCKETS - 1)] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t bucket = 0; bucket < RADIX_BUCKETS; bucket++) {
+            uint32_t bucketCount = histogram[bucket];
+            histogram[bucket]    = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            uint32_t destination  = histogram[(srcKeys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            dstKeys[destination]  = srcKeys[i];
+            dstOrder[destination] = srcOrder[i];
+        }
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcOrder, dstOrder);
+    }
+
+    // an odd number of scatter passes leaves the result in the scratch buffers
+    if (srcKeys != m_keys.data()) {
+        m_keys.swap(m_scratchKeys);
+        m_order.swap(m_scratchOrder);
+    }
+}
+
+void RenderQueue::record(GraphicsDevice& device, CommandBuffer cmd) const {
+    // the device skips binds of state that is already bound, so only the state changes between packets are recorded
+    for (uint32_t packetIndex : m_order) {
+        const DrawPacket& packet = m_packets[packetIndex];
+
+        device.bindPipeline(cmd, packet.pipeline);
+        if (packet.material && packet.materialOffset.has_value()) {
+            device.bindDescriptorSet(cmd, packet.pipeline, packet.material, packet.materialSetIndex, {packet.materialOffset.value()});
+        } else if (packet.material) {
+            device.bindDescriptorSet(cmd, packet.pipeline, packet.material, packet.materialSetIndex);
+        }
+        if (packet.vertexBuffer) {
+            device.bindVertexBuffer(cmd, packet.vertexBuffer);
+        }
+
+        if (packet.indexBuffer) {
+            device.bindIndexBuffer(cmd, packet.indexBuffer, packet.indexType);
+            device.drawIndexed(cmd, packet.count, packet.instanceCount, packet.firstIndex, packet.vertexOffset, packet.firstInstance);
+        } else {
+            device.draw(cmd, packet.count, packet.instanceCount, packet.firstIndex, packet.firstInstance);
+        }
+    }
+}
+
+} // namespace oz::gfx::vk
\ No newline at end of file
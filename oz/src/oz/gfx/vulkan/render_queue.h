@@ -0,0 +1,67 @@
+#pragma once
+
+#include "oz/gfx/vulkan/common.h"
+#include "oz/gfx/vulkan/enums.h"
+#include "oz/gfx/vulkan/objects.h"
+
+namespace oz::gfx::vk {
+
+class GraphicsDevice;
+
+// Draw Packet
+
+struct DrawPacket {
+    RenderPass              pipeline;             // render pass whose pipeline the draw uses
+    DescriptorSet           material;             // optional, bound at materialSetIndex
+    uint32_t                materialSetIndex = 0;
+    std::optional<uint32_t> materialOffset;       // dynamic offset of the material set, e.g. from GraphicsDevice::pushUniform
+    Buffer                  vertexBuffer;         // optional, for draws that generate their vertices
+    Buffer                  indexBuffer;          // optional, a non-indexed draw is recorded without it
+    IndexType               indexType     = IndexType::Uint16;
+    uint32_t                count         = 0;    // index count, or vertex count for non-indexed draws
+    uint32_t                instanceCount = 1;
+    uint32_t                firstIndex    = 0;    // first index, or first vertex for non-indexed draws
+    uint32_t                vertexOffset  = 0;
+    uint32_t                firstInstance = 0;
+};
+
+// Collects draw packets with 64-bit sort keys and records them in key order.
+// Key layout from the most significant bit: pass (4) | pipeline (12) | material (16) | mesh (16) | depth (16),
+// so packets sharing state end up next to each other and opaque draws of one state are recorded front-to-back.
+class RenderQueue final {
+  public:
+    static constexpr uint32_t PASS_BITS     = 4;
+    static constexpr uint32_t PIPELINE_BITS = 12;
+    static constexpr uint32_t MATERIAL_BITS = 16;
+    static constexpr uint32_t MESH_BITS     = 16;
+    static constexpr uint32_t DEPTH_BITS    = 16;
+
+    // depth is the normalized view depth in [0, 1], pass 1 - depth to sort back-to-front for blended passes
+    static uint64_t makeKey(uint32_t pass, RenderPass pipeline, DescriptorSet material, Buffer mesh, float depth);
+
+  public:
+    explicit RenderQueue(uint32_t capacity = 1 << 17);
+
+    void push(uint64_t key, const DrawPacket& packet);
+    void push(uint32_t pass, float depth, const DrawPacket& packet);
+    void clear();
+
+    // stable radix sort on the keys, packets are not moved
+    void sort();
+    // records the packets in sorted order, has to be called inside a begun render pass
+    void record(GraphicsDevice& device, CommandBuffer cmd) const;
+
+    uint32_t size() const { return static_cast<uint32_t>(m_packets.size()); }
+    bool     empty() const { return m_packets.empty(); }
+
+  private:
+    std::vector<DrawPacket> m_packets;
+    std::vector<uint64_t>   m_keys;
+    std::vector<uint32_t>   m_order;
+
+    // ping-pong buffers of the radix sort, kept around to avoid per-frame allocations
+    std::vector<uint64_t> m_scratchKeys;
+    std::vector<uint32_t> m_scratchOrder;
+};
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "oz/gfx/vulkan/common.h"
+
+namespace oz::gfx::vk {
+
+// Command Stats
+
+struct BindStats {
+    uint32_t issued = 0; // calls recorded into the command buffer
+    uint32_t elided = 0; // calls skipped because the state was already bound
+};
+
+struct DrawStats {
+    uint32_t calls     = 0;
+    uint64_t instances = 0;
+    uint64_t vertices  = 0; // of draw, per instance
+    uint64_t indices   = 0; // of drawIndexed, per instance
+};
+
+struct CommandStats {
+    BindStats pipeline;
+    BindStats viewportScissor;
+    BindStats vertexBuffer;
+    BindStats indexBuffer;
+    BindStats descriptorSet;
+    DrawStats draws;
+};
+
+inline BindStats& operator+=(BindStats& stats, const BindStats& other) {
+    stats.issued += other.issued;
+    stats.elided += other.elided;
+    return stats;
+}
+
+inline DrawStats& operator+=(DrawStats& stats, const DrawStats& other) {
+    stats.calls += other.calls;
+    stats.instances += other.instances;
+    stats.vertices += other.vertices;
+    stats.indices += other.indices;
+    return stats;
+}
+
+inline CommandStats& operator+=(CommandStats& stats, const CommandStats& other) {
+    stats.pipeline += other.pipeline;
+    stats.viewportScissor += other.viewportScissor;
+    stats.vertexBuffer += other.vertexBuffer;
+    stats.indexBuffer += other.indexBuffer;
+    stats.descriptorSet += other.descriptorSet;
+    stats.draws += other.draws;
+    return stats;
+}
+
+// Frame Stats
+
+// counted by the GPU, in the order of the VkQueryPipelineStatisticFlagBits they are queried with
+struct PipelineStats {
+    uint64_t inputAssemblyVertices     = 0;
+    uint64_t inputAssemblyPrimitives   = 0;
+    uint64_t vertexShaderInvocations   = 0;
+    uint64_t clippingInvocations       = 0; // primitives that reached the clipping stage
+    uint64_t clippingPrimitives        = 0; // primitives output by the clipping stage
+    uint64_t fragmentShaderInvocations = 0;
+};
+
+struct FrameStats {
+    CommandStats  commands;                         // of the command buffers submitted in the frame, executed bundles included
+    uint64_t      uploadedBytes           = 0;      // written by updateBuffer and uploadBuffer
+    uint32_t      submittedCommandBuffers = 0;
+    PipelineStats pipeline;                         // frame command buffer of the frame that last completed in this frame slot
+    bool          isPipelineStatsValid    = false;  // false if the device has no pipeline statistics queries
+};
+
+// Frame Timing Stats
+
+struct FrameTimingStats {
+    double pacingSleepMs    = 0.0; // slept in paceFrame before input was sampled
+    double waitMs           = 0.0; // blocked on the frame in flight and on image acquisition
+    double inputToPresentMs = 0.0; // from pollEvents to the present call, display latency after the call is not included
+    double framePeriodMs    = 0.0; // predicted interval between frames, 0 until the pacer has measured one
+    double gpuMs            = 0.0; // frame command buffer execution of the frame that last completed in this frame slot
+};
+
+// Host Memory Stats
+
+// driver allocations made through the VkAllocationCallbacks of the device
+struct HostScopeStats {
+    uint64_t bytes            = 0; // currently allocated
+    uint64_t peakBytes        = 0;
+    uint64_t allocations      = 0; // currently allocated
+    uint64_t totalAllocations = 0; // since the device was created
+    uint64_t internalBytes    = 0; // allocated by the driver itself, e.g. executable memory, reported through notifications
+};
+
+struct HostMemoryStats {
+    std::array<HostScopeStats, VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1> scopes; // indexed by VkSystemAllocationScope
+    uint64_t arenaBytes = 0; // reserved by the thread-local arenas, see HostAllocatorInfo
+};
+
+} // namespace oz::gfx::vk
\ No newline at end of file
@@ -1,4 +1,6 @@
 #pragma once
 
+#include "oz/asset/asset.h"
 #include "oz/core/core.h"
-#include "oz/gfx/gfx.h"
\ No newline at end of file
+#include "oz/gfx/gfx.h"
+#include "oz/scene/scene.h"
\ No newline at end of file
@@ -0,0 +1,379 @@
+#include "oz/scene/culling.h"
+#include "oz/core/job/job_system.h"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define OZ_CULLING_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OZ_CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+namespace oz::scene {
+
+namespace {
+
+// chunks smaller than this are not worth a thread
+static constexpr uint32_t MIN_CHUNK_SIZE = 4096;
+
+static bool isSphereVisible(const Frustum& frustum, float x, float y, float z, float radius) {
+    for (const glm::vec4& plane : frustum.planes) {
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isAabbVisible(const Frustum& frustum, float x, float y, float z, float extentX, float extentY, float extentZ) {
+    for (const glm::vec4& plane : frustum.planes) {
+        // projected radius of the box on the plane normal
+        float radius = std::abs(plane.x) * extentX + std::abs(plane.y) * extentY + std::abs(plane.z) * extentZ;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t writeVisibleIndices(uint32_t mask, uint32_t baseIndex, uint32_t* visibleIndices) {
+    uint32_t count = 0;
+    while (mask != 0) {
+        visibleIndices[count++] = baseIndex + std::countr_zero(mask);
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+#if defined(OZ_CULLING_AVX2)
+
+static constexpr uint32_t SIMD_WIDTH = 8;
+
+static uint32_t cullSpheresSimd(const Frustum& frustum, const SphereBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++) {
+        planeX[p] = _mm256_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm256_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm256_set1_ps(frustum.planes[p].w);
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; i += SIMD_WIDTH) {
+        __m256 x         = _mm256_loadu_ps(&bounds.centerX[i]);
+        __m256 y         = _mm256_loadu_ps(&bounds.centerY[i]);
+        __m256 z         = _mm256_loadu_ps(&bounds.centerZ[i]);
+        __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&bounds.radius[i]));
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], x), _mm256_mul_ps(planeY[p], y)),
+                                            _mm256_add_ps(_mm256_mul_ps(planeZ[p], z), planeW[p]));
+            visible         = _mm256_and_ps(visible, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+
+        count += writeVisibleIndices(static_cast<uint32_t>(_mm256_movemask_ps(visible)), i, visibleIndices + count);
+    }
+    return count;
+}
+
+static uint32_t cullAabbsSimd(const Frustum& frustum, const AabbBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+    __m256 absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+    for (int p = 0; p < 6; p++) {
+        planeX[p]    = _mm256_set1_ps(frustum.planes[p].x);
+        planeY[p]    = _mm256_set1_ps(frustum.planes[p].y);
+        planeZ[p]    = _mm256_set1_ps(frustum.planes[p].z);
+        planeW[p]    = _mm256_set1_ps(frustum.planes[p].w);
+        absPlaneX[p] = _mm256_set1_ps(std::abs(frustum.planes[p].x));
+        absPlaneY[p] = _mm256_set1_ps(std::abs(frustum.planes[p].y));
+        absPlaneZ[p] = _mm256_set1_ps(std::abs(frustum.planes[p].z));
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; i += SIMD_WIDTH) {
+        __m256 x       = _mm256_loadu_ps(&bounds.centerX[i]);
+        __m256 y       = _mm256_loadu_ps(&bounds.centerY[i]);
+        __m256 z       = _mm256_loadu_ps(&bounds.centerZ[i]);
+        __m256 extentX = _mm256_loadu_ps(&bounds.extentX[i]);
+        __m256 extentY = _mm256_loadu_ps(&bounds.extentY[i]);
+        __m256 extentZ = _mm256_loadu_ps(&bounds.extentZ[i]);
+
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(planeX[p], x), _mm256_mul_ps(planeY[p], y)),
+                                            _mm256_add_ps(_mm256_mul_ps(planeZ[p], z), planeW[p]));
+            __m256 radius   = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(absPlaneX[p], extentX), _mm256_mul_ps(absPlaneY[p], extentY)),
+                                          _mm256_mul_ps(absPlaneZ[p], extentZ));
+            visible         = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        count += writeVisibleIndices(static_cast<uint32_t>(_mm256_movemask_ps(visible)), i, visibleIndices + count);
+    }
+    return count;
+}
+
+#elif defined(OZ_CULLING_SSE)
+
+static constexpr uint32_t SIMD_WIDTH = 4;
+
+static uint32_t cullSpheresSimd(const Frustum& frustum, const SphereBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (int p = 0; p < 6; p++) {
+        planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; i += SIMD_WIDTH) {
+        __m128 x         = _mm_loadu_ps(&bounds.centerX[i]);
+        __m128 y         = _mm_loadu_ps(&bounds.centerY[i]);
+        __m128 z         = _mm_loadu_ps(&bounds.centerZ[i]);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&bounds.radius[i]));
+
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m128 distance =
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)), _mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        count += writeVisibleIndices(static_cast<uint32_t>(_mm_movemask_ps(visible)), i, visibleIndices + count);
+    }
+    return count;
+}
+
+static uint32_t cullAabbsSimd(const Frustum& frustum, const AabbBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+    __m128 absPlaneX[6], absPlaneY[6], absPlaneZ[6];
+    for (int p = 0; p < 6; p++) {
+        planeX[p]    = _mm_set1_ps(frustum.planes[p].x);
+        planeY[p]    = _mm_set1_ps(frustum.planes[p].y);
+        planeZ[p]    = _mm_set1_ps(frustum.planes[p].z);
+        planeW[p]    = _mm_set1_ps(frustum.planes[p].w);
+        absPlaneX[p] = _mm_set1_ps(std::abs(frustum.planes[p].x));
+        absPlaneY[p] = _mm_set1_ps(std::abs(frustum.planes[p].y));
+        absPlaneZ[p] = _mm_set1_ps(std::abs(frustum.planes[p].z));
+    }
+
+    uint32_t count = 0;
+    for (uint32_t i = begin; i < end; i += SIMD_WIDTH) {
+        __m128 x       = _mm_loadu_ps(&bounds.centerX[i]);
+        __m128 y       = _mm_loadu_ps(&bounds.centerY[i]);
+        __m128 z       = _mm_loadu_ps(&bounds.centerZ[i]);
+        __m128 extentX = _mm_loadu_ps(&bounds.extentX[i]);
+        __m128 extentY = _mm_loadu_ps(&bounds.extentY[i]);
+        __m128 extentZ = _mm_loadu_ps(&bounds.extentZ[i]);
+
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m128 distance =
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)), _mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+            __m128 radius =
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(absPlaneX[p], extentX), _mm_mul_ps(absPlaneY[p], extentY)), _mm_mul_ps(absPlaneZ[p], extentZ));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        count += writeVisibleIndices(static_cast<uint32_t>(_mm_movemask_ps(visible)), i, visibleIndices + count);
+    }
+    return count;
+}
+
+#endif
+
+template <typename Bounds, typename CullChunk>
+static void cullParallel(const Bounds& bounds, std::vector<uint32_t>& visibleIndices, uint32_t threadCount, CullChunk cullChunk) {
+    const uint32_t count = bounds.size();
+    visibleIndices.resize(count);
+
+    job::JobSystem& jobSystem = job::getJobSystem();
+    if (threadCount == 0) {
+        threadCount = jobSystem.getWorkerCount() * job::JobSystem::RANGES_PER_WORKER;
+    }
+    uint32_t chunkCount = std::clamp((count + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE, 1u, threadCount);
+
+    if (chunkCount == 1) {
+        visibleIndices.resize(cullChunk(0, count, visibleIndices.data()));
+        return;
+    }
+
+    // every chunk writes into its own range of the output, the ranges are compacted afterwards
+    uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    chunkSize          = (chunkSize + 7) & ~7u; // keep the chunk starts aligned to the widest simd width
+
+    std::vector<uint32_t> visibleCounts(chunkCount, 0);
+    jobSystem.parallelFor(chunkCount, 1, chunkCount, [&](uint32_t firstChunk, uint32_t lastChunk) {
+        for (uint32_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+            uint32_t begin       = std::min(chunk * chunkSize, count);
+            uint32_t end         = std::min(begin + chunkSize, count);
+            visibleCounts[chunk] = cullChunk(begin, end, visibleIndices.data() + begin);
+        }
+    });
+
+    uint32_t visibleCount = visibleCounts[0];
+    for (uint32_t chunk = 1; chunk < chunkCount; chunk++) {
+        uint32_t begin = std::min(chunk * chunkSize, count);
+        std::memmove(visibleIndices.data() + visibleCount, visibleIndices.data() + begin, visibleCounts[chunk] * sizeof(uint32_t));
+        visibleCount += visibleCounts[chunk];
+    }
+    visibleIndices.resize(visibleCount);
+}
+
+} // namespace
+
+Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+    // glm matrices are column major, m[column][row]
+    auto row = [&](int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+
+    Frustum frustum;
+    frustum.planes[0] = row(3) + row(0); // left
+    frustum.planes[1] = row(3) - row(0); // right
+    frustum.planes[2] = row(3) + row(1); // bottom
+    frustum.planes[3] = row(3) - row(1); // top
+    frustum.planes[4] = row(3) + row(2); // near, conservative for the [0, 1] depth range as well
+    frustum.planes[5] = row(3) - row(2); // far
+
+    for (glm::vec4& plane : frustum.planes) {
+        plane = plane / glm::length(glm::vec3(plane.x, plane.y, plane.z));
+    }
+
+    return frustum;
+}
+
+void SphereBounds::add(const glm::vec3& center, float _radius) {
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(_radius);
+}
+
+void SphereBounds::set(uint32_t index, const glm::vec3& center, float _radius) {
+    centerX[index] = center.x;
+    centerY[index] = center.y;
+    centerZ[index] = center.z;
+    radius[index]  = _radius;
+}
+
+void SphereBounds::reserve(uint32_t capacity) {
+    centerX.reserve(capacity);
+    centerY.reserve(capacity);
+    centerZ.reserve(capacity);
+    radius.reserve(capacity);
+}
+
+void SphereBounds::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    radius.clear();
+}
+
+void AabbBounds::add(const glm::vec3& min, const glm::vec3& max) {
+    centerX.push_back((min.x + max.x) * 0.5f);
+    centerY.push_back((min.y + max.y) * 0.5f);
+    centerZ.push_back((min.z + max.z) * 0.5f);
+    extentX.push_back((max.x - min.x) * 0.5f);
+    extentY.push_back((max.y - min.y) * 0.5f);
+    extentZ.push_back((max.z - min.z) * 0.5f);
+}
+
+void AabbBounds::set(uint32_t index, const glm::vec3& min, const glm::vec3& max) {
+    centerX[index] = (min.x + max.x) * 0.5f;
+    centerY[index] = (min.y + max.y) * 0.5f;
+    centerZ[index] = (min.z + max.z) * 0.5f;
+    extentX[index] = (max.x - min.x) * 0.5f;
+    extentY[index] = (max.y - min.y) * 0.5f;
+    extentZ[index] = (max.z - min.z) * 0.5f;
+}
+
+void AabbBounds::reserve(uint32_t capacity) {
+    centerX.reserve(capacity);
+    centerY.reserve(capacity);
+    centerZ.reserve(capacity);
+    extentX.reserve(capacity);
+    extentY.reserve(capacity);
+    extentZ.reserve(capacity);
+}
+
+void AabbBounds::clear() {
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    extentX.clear();
+    extentY.clear();
+    extentZ.clear();
+}
+
+uint32_t cullSpheres(const Frustum& frustum, const SphereBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+    assert(begin <= end && end <= bounds.size());
+
+    uint32_t count = 0;
+    uint32_t i     = begin;
+
+#if defined(OZ_CULLING_AVX2) || defined(OZ_CULLING_SSE)
+    uint32_t simdEnd = begin + (end - begin) / SIMD_WIDTH * SIMD_WIDTH;
+    count += cullSpheresSimd(frustum, bounds, begin, simdEnd, visibleIndices);
+    i = simdEnd;
+#endif
+
+    // remainder, or everything without simd
+    for (; i < end; i++) {
+        if (isSphereVisible(frustum, bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i], bounds.radius[i])) {
+            visibleIndices[count++] = i;
+        }
+    }
+
+    return count;
+}
+
+uint32_t cullAabbs(const Frustum& frustum, const AabbBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices) {
+    assert(begin <= end && end <= bounds.size());
+
+    uint32_t count = 0;
+    uint32_t i     = begin;
+
+#if defined(OZ_CULLING_AVX2) || defined(OZ_CULLING_SSE)
+    uint32_t simdEnd = begin + (end - begin) / SIMD_WIDTH * SIMD_WIDTH;
+    count += cullAabbsSimd(frustum, bounds, begin, simdEnd, visibleIndices);
+    i = simdEnd;
+#endif
+
+    // remainder, or everything without simd
+    for (; i < end; i++) {
+        if (isAabbVisible(
+                frustum, bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i], bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i])) {
+            visibleIndices[count++] = i;
+        }
+    }
+
+    return count;
+}
+
+void cullSpheres(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visibleIndices, uint32_t threadCount) {
+    cullParallel(bounds, visibleIndices, threadCount, [&](uint32_t begin, uint32_t end, uint32_t* output) {
+        return cullSpheres(frustum, bounds, begin, end, output);
+    });
+}
+
+void cullAabbs(const Frustum& frustum, const AabbBounds& bounds, std::vector<uint32_t>& visibleIndices, uint32_t threadCount) {
+    cullParallel(bounds, visibleIndices, threadCount, [&](uint32_t begin, uint32_t end, uint32_t* output) {
+        return cullAabbs(frustum, bounds, begin, end, output);
+    });
+}
+
+const char* getCullingBackend() {
+#if defined(OZ_CULLING_AVX2)
+    return "avx2";
+#elif defined(OZ_CULLING_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace oz::scene
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "oz/common.h"
+
+namespace oz::scene {
+
+// Frustum planes as (normal, distance) pairs pointing inwards, a point p is inside a plane if dot(normal, p) + distance >= 0.
+struct Frustum {
+    std::array<glm::vec4, 6> planes;
+
+    // extracts the planes of a glm view-projection matrix
+    static Frustum fromMatrix(const glm::mat4& viewProjection);
+};
+
+// Bounds are stored as separate component arrays so that the culling loops load several objects per instruction.
+
+struct SphereBounds {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> radius;
+
+    void     add(const glm::vec3& center, float radius);
+    void     set(uint32_t index, const glm::vec3& center, float radius);
+    void     reserve(uint32_t capacity);
+    void     clear();
+    uint32_t size() const { return static_cast<uint32_t>(radius.size()); }
+};
+
+struct AabbBounds {
+    std::vector<float> centerX, centerY, centerZ;
+    std::vector<float> extentX, extentY, extentZ; // half sizes
+
+    void     add(const glm::vec3& min, const glm::vec3& max);
+    void     set(uint32_t index, const glm::vec3& min, const glm::vec3& max);
+    void     reserve(uint32_t capacity);
+    void     clear();
+    uint32_t size() const { return static_cast<uint32_t>(extentX.size()); }
+};
+
+// Tests the bounds in [begin, end) and writes the indices of the visible ones in ascending order, returns the visible count.
+// visibleIndices has to hold end - begin entries. Ranges are independent, so chunks can be culled in parallel into disjoint outputs.
+uint32_t cullSpheres(const Frustum& frustum, const SphereBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices);
+uint32_t cullAabbs(const Frustum& frustum, const AabbBounds& bounds, uint32_t begin, uint32_t end, uint32_t* visibleIndices);
+
+// Culls every bound in up to threadCount chunks run as jobs of the job system, 0 lets the job system pick.
+// visibleIndices is resized to the visible count and ends up sorted, ready to be walked for draw recording.
+void cullSpheres(const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visibleIndices, uint32_t threadCount = 0);
+void cullAabbs(const Frustum& frustum, const AabbBounds& bounds, std::vector<uint32_t>& visibleIndices, uint32_t threadCount = 0);
+
+// name of the instruction set the culling loops were compiled for
+const char* getCullingBackend();
+
+} // namespace oz::scene
\ No newline at end of file
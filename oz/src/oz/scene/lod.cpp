@@ -0,0 +1,31 @@
+#include "oz/scene/lod.h"
+
+namespace oz::scene {
+
+LodSelector LodSelector::fromPerspective(const glm::vec3& cameraPosition, float fovY, float viewportHeight, float threshold) {
+    LodSelector selector;
+    selector.cameraPosition  = cameraPosition;
+    selector.projectionScale = viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+    selector.threshold       = threshold;
+
+    return selector;
+}
+
+float LodSelector::getProjectedSize(const glm::vec3& center, float radius, float length) const {
+    // inside the sphere the object covers the screen, the small minimum keeps the division finite
+    float distance = std::max(glm::length(center - cameraPosition) - radius, 1e-4f);
+    return length * projectionScale / distance;
+}
+
+uint32_t LodSelector::select(const glm::vec3& center, float radius, float scale, const asset::MeshLod* lods, uint32_t lodCount) const {
+    // errors grow along the chain, the coarsest level under the threshold wins
+    float    maxError = threshold / getProjectedSize(center, radius, scale);
+    uint32_t level    = 0;
+    while (level < lodCount && lods[level].error <= maxError) {
+        level++;
+    }
+
+    return level;
+}
+
+} // namespace oz::scene
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "oz/asset/mesh.h"
+#include "oz/common.h"
+
+namespace oz::scene {
+
+// Picks mesh levels of detail by the projected screen size of their simplification error,
+// so the triangle count of an object follows the pixels it covers instead of the mesh it was authored with.
+struct LodSelector {
+    glm::vec3 cameraPosition  = glm::vec3(0.0f);
+    float     projectionScale = 1.0f; // pixels covered by one world unit at distance one
+    float     threshold       = 1.0f; // largest accepted error in pixels
+
+    static LodSelector fromPerspective(const glm::vec3& cameraPosition, float fovY, float viewportHeight, float threshold = 1.0f);
+
+    // size in pixels of a world space length at the nearest point of a bounding sphere
+    float getProjectedSize(const glm::vec3& center, float radius, float length) const;
+
+    // Returns 0 for the full detail range, or l for lods[l - 1] where lods points at the submesh's first lod.
+    // scale converts the object space lod errors to world units.
+    uint32_t select(const glm::vec3& center, float radius, float scale, const asset::MeshLod* lods, uint32_t lodCount) const;
+};
+
+} // namespace oz::scene
\ No newline at end of file
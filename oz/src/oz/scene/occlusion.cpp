@@ -0,0 +1,219 @@
+#include "oz/scene/occlusion.h"
+#include "oz/core/job/job_system.h"
+
+#include <bit>
+#include <cstring>
+
+namespace oz::scene {
+
+namespace {
+
+// ranges smaller than this are not worth a job
+static constexpr uint32_t MIN_ROW_COUNT  = 16;   // pyramid rows
+static constexpr uint32_t MIN_CHUNK_SIZE = 1024; // occlusion candidates
+
+// clip space position of a world position, spelled out so it works on the columns of the matrix directly
+static glm::vec4 project(const glm::mat4& m, float x, float y, float z) { return m[0] * x + m[1] * y + m[2] * z + m[3]; }
+
+// filters the indices in place, chunks are filtered in parallel and compacted afterwards, returns the kept count
+template <typename IsKept>
+static uint32_t filterParallel(uint32_t* indices, uint32_t count, uint32_t threadCount, IsKept isKept) {
+    job::JobSystem& jobSystem = job::getJobSystem();
+    if (threadCount == 0) {
+        threadCount = jobSystem.getWorkerCount() * job::JobSystem::RANGES_PER_WORKER;
+    }
+    const uint32_t chunkCount = std::clamp((count + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE, 1u, threadCount);
+    const uint32_t chunkSize  = (count + chunkCount - 1) / std::max(chunkCount, 1u);
+
+    std::vector<uint32_t> keptCounts(chunkCount, 0);
+    jobSystem.parallelFor(chunkCount, 1, chunkCount, [&](uint32_t firstChunk, uint32_t lastChunk) {
+        for (uint32_t chunk = firstChunk; chunk < lastChunk; chunk++) {
+            uint32_t begin = std::min(chunk * chunkSize, count);
+            uint32_t end   = std::min(begin + chunkSize, count);
+            uint32_t kept  = begin;
+            for (uint32_t i = begin; i < end; i++) {
+                if (isKept(indices[i])) {
+                    indices[kept++] = indices[i];
+                }
+            }
+            keptCounts[chunk] = kept - begin;
+        }
+    });
+
+    uint32_t keptCount = keptCounts[0];
+    for (uint32_t chunk = 1; chunk < chunkCount; chunk++) {
+        uint32_t begin = std::min(chunk * chunkSize, count);
+        std::memmove(indices + keptCount, indices + begin, keptCounts[chunk] * sizeof(uint32_t));
+        keptCount += keptCounts[chunk];
+    }
+    return keptCount;
+}
+
+template <typename Bounds, typename FrustumCull, typename GetExtent>
+static CullingStats cullOccluded(const DepthPyramid&    pyramid,
+                                 const Bounds&          bounds,
+                                 std::vector<uint32_t>& visibleIndices,
+                                 const CullingSettings& settings,
+                                 uint32_t               threadCount,
+                                 FrustumCull            frustumCull,
+                                 GetExtent              getExtent) {
+    CullingStats stats;
+    stats.tested = bounds.size();
+
+    if (settings.isFrustumCullingEnabled) {
+        frustumCull();
+    } else {
+        visibleIndices.resize(bounds.size());
+        for (uint32_t i = 0; i < bounds.size(); i++) {
+            visibleIndices[i] = i;
+        }
+    }
+    stats.frustumRejected = stats.tested - static_cast<uint32_t>(visibleIndices.size());
+
+    if (settings.isOcclusionCullingEnabled && !pyramid.empty()) {
+        const uint32_t count     = static_cast<uint32_t>(visibleIndices.size());
+        const uint32_t keptCount = filterParallel(visibleIndices.data(), count, threadCount, [&](uint32_t i) {
+            return !pyramid.isOccluded(glm::vec3(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]), getExtent(i));
+        });
+        visibleIndices.resize(keptCount);
+        stats.occlusionRejected = count - keptCount;
+    }
+
+    stats.visible = static_cast<uint32_t>(visibleIndices.size());
+    return stats;
+}
+
+} // namespace
+
+void DepthPyramid::build(const float* depth, uint32_t width, uint32_t height, const glm::mat4& viewProjection) {
+    assert(width > 0 && height > 0);
+    m_viewProjection = viewProjection;
+
+    // levels down to a single texel, the storage of existing levels is reused
+    uint32_t levelCount = 1;
+    for (uint32_t size = std::max(width, height); size > 1; size = (size + 1) / 2) {
+        levelCount++;
+    }
+    m_levels.resize(levelCount);
+
+    m_levels[0].width  = width;
+    m_levels[0].height = height;
+    m_levels[0].depth.assign(depth, depth + size_t(width) * height);
+
+    job::JobSystem& jobSystem = job::getJobSystem();
+    for (uint32_t level = 1; level < levelCount; level++) {
+        const Level& source = m_levels[level - 1];
+        Level&       target = m_levels[level];
+        target.width        = std::max(1u, (source.width + 1) / 2);
+        target.height       = std::max(1u, (source.height + 1) / 2);
+        target.depth.resize(size_t(target.width) * target.height);
+
+        // odd sizes clamp to the last texel, so the last target texel also covers the remaining source texels
+        jobSystem.parallelFor(target.height, MIN_ROW_COUNT, 0, [&](uint32_t firstRow, uint32_t lastRow) {
+            for (uint32_t y = firstRow; y < lastRow; y++) {
+                const float* row0 = &source.depth[size_t(std::min(2 * y, source.height - 1)) * source.width];
+                const float* row1 = &source.depth[size_t(std::min(2 * y + 1, source.height - 1)) * source.width];
+                float*       out  = &target.depth[size_t(y) * target.width];
+                for (uint32_t x = 0; x < target.width; x++) {
+                    const uint32_t x0 = std::min(2 * x, source.width - 1);
+                    const uint32_t x1 = std::min(2 * x + 1, source.width - 1);
+                    out[x]            = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+                }
+            }
+        });
+    }
+}
+
+void DepthPyramid::clear() { m_levels.clear(); }
+
+bool DepthPyramid::isOccluded(const glm::vec3& center, const glm::vec3& extent) const {
+    if (m_levels.empty()) {
+        return false;
+    }
+
+    // screen rectangle and nearest depth of the box corners
+    float minX = 1.0f, minY = 1.0f, maxX = -1.0f, maxY = -1.0f;
+    float nearestDepth = 1.0f;
+    for (uint32_t corner = 0; corner < 8; corner++) {
+        const glm::vec4 clip = project(m_viewProjection,
+                                       center.x + (corner & 1 ? extent.x : -extent.x),
+                                       center.y + (corner & 2 ? extent.y : -extent.y),
+                                       center.z + (corner & 4 ? extent.z : -extent.z));
+        if (clip.w <= 1e-6f) {
+            return false; // crosses the camera plane, the projection is not bounded
+        }
+        const float invW = 1.0f / clip.w;
+        minX             = std::min(minX, clip.x * invW);
+        minY             = std::min(minY, clip.y * invW);
+        maxX             = std::max(maxX, clip.x * invW);
+        maxY             = std::max(maxY, clip.y * invW);
+        nearestDepth     = std::min(nearestDepth, clip.z * invW);
+    }
+    if (nearestDepth <= 0.0f) {
+        return false; // reaches the near plane
+    }
+
+    // texels of level 0 covered by the rectangle, clamped to the screen
+    const Level&   base    = m_levels[0];
+    const uint32_t texMinX = static_cast<uint32_t>(std::clamp((minX * 0.5f + 0.5f) * base.width, 0.0f, float(base.width - 1)));
+    const uint32_t texMinY = static_cast<uint32_t>(std::clamp((minY * 0.5f + 0.5f) * base.height, 0.0f, float(base.height - 1)));
+    const uint32_t texMaxX = static_cast<uint32_t>(std::clamp((maxX * 0.5f + 0.5f) * base.width, 0.0f, float(base.width - 1)));
+    const uint32_t texMaxY = static_cast<uint32_t>(std::clamp((maxY * 0.5f + 0.5f) * base.height, 0.0f, float(base.height - 1)));
+
+    // the finest level where the rectangle spans at most two texels in each direction, a texel of level l covers
+    // 2^l texels of level 0 in each direction
+    const uint32_t size  = std::max(texMaxX - texMinX, texMaxY - texMinY) + 1;
+    uint32_t       level = std::min<uint32_t>(std::bit_width(size - 1), getLevelCount() - 1);
+    while (level > 0 && (texMaxX >> (level - 1)) - (texMinX >> (level - 1)) <= 1 && (texMaxY >> (level - 1)) - (texMinY >> (level - 1)) <= 1) {
+        level--;
+    }
+
+    const Level&   target = m_levels[level];
+    const uint32_t x0     = std::min(texMinX >> level, target.width - 1);
+    const uint32_t y0     = std::min(texMinY >> level, target.height - 1);
+    const uint32_t x1     = std::min(texMaxX >> level, target.width - 1);
+    const uint32_t y1     = std::min(texMaxY >> level, target.height - 1);
+
+    float farthestDepth = 0.0f;
+    for (uint32_t y = y0; y <= y1; y++) {
+        for (uint32_t x = x0; x <= x1; x++) {
+            farthestDepth = std::max(farthestDepth, target.depth[size_t(y) * target.width + x]);
+        }
+    }
+
+    return nearestDepth > farthestDepth;
+}
+
+CullingStats cullSpheres(const Frustum&         frustum,
+                         const DepthPyramid&    pyramid,
+                         const SphereBounds&    bounds,
+                         std::vector<uint32_t>& visibleIndices,
+                         const CullingSettings& settings,
+                         uint32_t               threadCount) {
+    return cullOccluded(
+        pyramid,
+        bounds,
+        visibleIndices,
+        settings,
+        threadCount,
+        [&]() { cullSpheres(frustum, bounds, visibleIndices, threadCount); },
+        [&](uint32_t i) { return glm::vec3(bounds.radius[i]); });
+}
+
+CullingStats cullAabbs(const Frustum&         frustum,
+                       const DepthPyramid&    pyramid,
+                       const AabbBounds&      bounds,
+                       std::vector<uint32_t>& visibleIndices,
+                       const CullingSettings& settings,
+                       uint32_t               threadCount) {
+    return cullOccluded(
+        pyramid,
+        bounds,
+        visibleIndices,
+        settings,
+        threadCount,
+        [&]() { cullAabbs(frustum, bounds, visibleIndices, threadCount); },
+        [&](uint32_t i) { return glm::vec3(bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]); });
+}
+
+} // namespace oz::scene
\ No newline at end of file
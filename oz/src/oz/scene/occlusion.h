@@ -0,0 +1,68 @@
+#pragma once
+
+#include "oz/scene/culling.h"
+
+namespace oz::scene {
+
+// Hierarchical depth of a rendered frame. Level 0 is the depth buffer, every further level halves the size and keeps the
+// farthest depth of the texels below it, so one texel of a coarse level bounds the depth of its whole footprint.
+// Depth is in [0, 1] with 1 at the far plane, rows start at the top of the screen like a Vulkan depth attachment.
+class DepthPyramid final {
+  public:
+    // builds the levels from the depth buffer of a frame rendered with viewProjection, e.g. the previous frame read back
+    // with GraphicsDevice::readBuffer, the rows of a level are reduced in parallel by the job system
+    void build(const float* depth, uint32_t width, uint32_t height, const glm::mat4& viewProjection);
+    void clear();
+
+    // conservative, true only if the box is entirely behind the depth stored in the pyramid
+    bool isOccluded(const glm::vec3& center, const glm::vec3& extent) const;
+
+    bool             empty() const { return m_levels.empty(); }
+    uint32_t         getLevelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+    uint32_t         getWidth(uint32_t level) const { return m_levels[level].width; }
+    uint32_t         getHeight(uint32_t level) const { return m_levels[level].height; }
+    float            getDepth(uint32_t level, uint32_t x, uint32_t y) const { return m_levels[level].depth[y * m_levels[level].width + x]; }
+    const glm::mat4& getViewProjection() const { return m_viewProjection; }
+
+  private:
+    struct Level {
+        uint32_t           width  = 0;
+        uint32_t           height = 0;
+        std::vector<float> depth;
+    };
+
+    std::vector<Level> m_levels;
+    glm::mat4          m_viewProjection = glm::mat4(1.0f);
+};
+
+// Toggles of the culling stages, disabled stages let everything pass.
+struct CullingSettings {
+    bool isFrustumCullingEnabled   = true;
+    bool isOcclusionCullingEnabled = true;
+};
+
+// Objects rejected by each stage of the last cull.
+struct CullingStats {
+    uint32_t tested            = 0;
+    uint32_t frustumRejected   = 0;
+    uint32_t occlusionRejected = 0;
+    uint32_t visible           = 0;
+};
+
+// Frustum culls the bounds and tests the survivors against the depth pyramid of the previous frame, so objects hidden
+// behind others are dropped before they are drawn. Objects that became visible this frame show up one frame late.
+// An empty pyramid skips the occlusion stage. visibleIndices ends up sorted like the results of the frustum culling.
+CullingStats cullSpheres(const Frustum&         frustum,
+                         const DepthPyramid&    pyramid,
+                         const SphereBounds&    bounds,
+                         std::vector<uint32_t>& visibleIndices,
+                         const CullingSettings& settings    = {},
+                         uint32_t               threadCount = 0);
+CullingStats cullAabbs(const Frustum&         frustum,
+                       const DepthPyramid&    pyramid,
+                       const AabbBounds&      bounds,
+                       std::vector<uint32_t>& visibleIndices,
+                       const CullingSettings& settings    = {},
+                       uint32_t               threadCount = 0);
+
+} // namespace oz::scene
\ No newline at end of file
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "oz/scene/culling.h"
+#include "oz/scene/lod.h"
+#include "oz/scene/occlusion.h"
+#include "oz/scene/transform.h"
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "oz/scene/transform.h"
+#include "oz/core/job/job_system.h"
+
+#include <cstring>
+
+namespace oz::scene {
+
+namespace {
+
+// hierarchies smaller than this are updated on the calling thread
+static constexpr uint32_t MIN_PARALLEL_SIZE = 4096;
+static constexpr uint32_t MIN_RANGE_SIZE    = 1024; // smallest slice of a level that is run as a job
+
+static glm::mat4 composeMatrix(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+    glm::mat3 rotationMatrix = glm::mat3_cast(rotation);
+
+    return glm::mat4(glm::vec4(rotationMatrix[0] * scale.x, 0.0f),
+                     glm::vec4(rotationMatrix[1] * scale.y, 0.0f),
+                     glm::vec4(rotationMatrix[2] * scale.z, 0.0f),
+                     glm::vec4(translation, 1.0f));
+}
+
+} // namespace
+
+TransformHierarchy::TransformHierarchy(uint32_t capacity) {
+    m_translations.reserve(capacity);
+    m_rotations.reserve(capacity);
+    m_scales.reserve(capacity);
+    m_parents.reserve(capacity);
+    m_depths.reserve(capacity);
+    m_worldMatrices.reserve(capacity);
+    m_order.reserve(capacity);
+}
+
+uint32_t TransformHierarchy::add(uint32_t parent, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale) {
+    uint32_t id = size();
+    if (parent != NO_PARENT && parent >= id) {
+        throw std::runtime_error("Transform parent has to be added before its children!");
+    }
+
+    m_translations.push_back(translation);
+    m_rotations.push_back(rotation);
+    m_scales.push_back(scale);
+    m_parents.push_back(parent);
+    m_depths.push_back(parent == NO_PARENT ? 0 : m_depths[parent] + 1);
+    m_worldMatrices.push_back(glm::mat4(1.0f));
+
+    m_isOrderDirty = true;
+
+    return id;
+}
+
+void TransformHierarchy::clear() {
+    m_translations.clear();
+    m_rotations.clear();
+    m_scales.clear();
+    m_parents.clear();
+    m_depths.clear();
+    m_worldMatrices.clear();
+    m_order.clear();
+    m_levelOffsets.clear();
+    m_isOrderDirty = false;
+}
+
+void TransformHierarchy::sortByDepth() {
+    // counting sort, stable so that siblings keep their memory order
+    uint32_t maxDepth = 0;
+    for (uint32_t depth : m_depths) {
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    m_levelOffsets.assign(maxDepth + 2, 0);
+    for (uint32_t depth : m_depths) {
+        m_levelOffsets[depth + 1]++;
+    }
+    for (uint32_t level = 1; level < m_levelOffsets.size(); level++) {
+        m_levelOffsets[level] += m_levelOffsets[level - 1];
+    }
+
+    m_order.resize(size());
+    std::vector<uint32_t> cursors(m_levelOffsets.begin(), m_levelOffsets.end() - 1);
+    for (uint32_t id = 0; id < size(); id++) {
+        m_order[cursors[m_depths[id]]++] = id;
+    }
+
+    m_isOrderDirty = false;
+}
+
+void TransformHierarchy::updateRange(uint32_t begin, uint32_t end, glm::mat4* gpuWorldMatrices) {
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t  id    = m_order[i];
+        glm::mat4 local = composeMatrix(m_translations[id], m_rotations[id], m_scales[id]);
+
+        uint32_t parent     = m_parents[id];
+        m_worldMatrices[id] = parent == NO_PARENT ? local : m_worldMatrices[parent] * local;
+
+        // the gpu copy is only written, mapped memory is often uncached for reads
+        if (gpuWorldMatrices != nullptr) {
+            std::memcpy(&gpuWorldMatrices[id], &m_worldMatrices[id], sizeof(glm::mat4));
+        }
+    }
+}
+
+void TransformHierarchy::update(glm::mat4* gpuWorldMatrices, uint32_t threadCount) {
+    if (m_isOrderDirty) {
+        sortByDepth();
+    }
+
+    if (size() < MIN_PARALLEL_SIZE || threadCount == 1) {
+        updateRange(0, size(), gpuWorldMatrices);
+        return;
+    }
+
+    // a level is complete before its children are computed, the slices of one level run as jobs
+    job::JobSystem& jobSystem  = job::getJobSystem();
+    const uint32_t  levelCount = static_cast<uint32_t>(m_levelOffsets.size()) - 1;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        uint32_t levelBegin = m_levelOffsets[level];
+        uint32_t levelSize  = m_levelOffsets[level + 1] - levelBegin;
+
+        jobSystem.parallelFor(levelSize, MIN_RANGE_SIZE, threadCount, [&](uint32_t begin, uint32_t end) {
+            updateRange(levelBegin + begin, levelBegin + end, gpuWorldMatrices);
+        });
+    }
+}
+
+} // namespace oz::scene
\ No newline at end of file
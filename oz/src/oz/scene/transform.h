@@ -0,0 +1,57 @@
+#pragma once
+
+#include "oz/common.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace oz::scene {
+
+// Local translation/rotation/scale of many objects stored in separate arrays, with world matrices computed in batches.
+// Nodes are addressed by the id returned from add(), which also indexes the world matrices written to the GPU.
+class TransformHierarchy final {
+  public:
+    static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+    explicit TransformHierarchy(uint32_t capacity = 0);
+
+    // the parent has to be added before its children
+    uint32_t add(uint32_t         parent      = NO_PARENT,
+                 const glm::vec3& translation = glm::vec3(0.0f),
+                 const glm::quat& rotation    = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                 const glm::vec3& scale       = glm::vec3(1.0f));
+    void     clear();
+
+    void setTranslation(uint32_t id, const glm::vec3& translation) { m_translations[id] = translation; }
+    void setRotation(uint32_t id, const glm::quat& rotation) { m_rotations[id] = rotation; }
+    void setScale(uint32_t id, const glm::vec3& scale) { m_scales[id] = scale; }
+
+    // computes every world matrix, depth levels are processed one after another and each level is split into up to
+    // threadCount jobs of the job system, 0 lets the job system pick
+    // when gpuWorldMatrices is set the matrices are also written there by id, e.g. to the mapped memory of a storage buffer
+    void update(glm::mat4* gpuWorldMatrices = nullptr, uint32_t threadCount = 0);
+
+    const glm::mat4& getWorldMatrix(uint32_t id) const { return m_worldMatrices[id]; }
+    uint32_t         getParent(uint32_t id) const { return m_parents[id]; }
+    uint32_t         size() const { return static_cast<uint32_t>(m_parents.size()); }
+
+  private:
+    void sortByDepth();
+    void updateRange(uint32_t begin, uint32_t end, glm::mat4* gpuWorldMatrices);
+
+  private:
+    // local transforms, indexed by id
+    std::vector<glm::vec3> m_translations;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scales;
+    std::vector<uint32_t>  m_parents;
+    std::vector<uint32_t>  m_depths;
+
+    std::vector<glm::mat4> m_worldMatrices;
+
+    // ids sorted by depth, parents always come before their children, and the start of every depth level in it
+    std::vector<uint32_t> m_order;
+    std::vector<uint32_t> m_levelOffsets;
+    bool                  m_isOrderDirty = false;
+};
+
+} // namespace oz::scene
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "oz/oz.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+using namespace oz::gfx::vk;
+
+// Every operator new of the process is counted, the replacements below forward to malloc and free.
+// Drivers written in C++ share the replacements, their allocations are counted as well.
+namespace {
+
+std::atomic<uint64_t> s_allocationCount = 0;
+
+void* allocate(std::size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+    return _aligned_malloc(size != 0 ? size : 1, align);
+#else
+    void* memory = nullptr;
+    return posix_memalign(&memory, align, size != 0 ? size : 1) == 0 ? memory : nullptr;
+#endif
+}
+
+void freeAligned(void* memory) {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    void* memory = allocate(size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* memory = allocateAligned(size, alignment);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { freeAligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { freeAligned(memory); }
+
+namespace {
+
+static constexpr uint32_t WARM_UP_FRAME_COUNT = 1; // grows the per-frame containers to their steady-state size
+static constexpr uint32_t TEST_FRAME_COUNT    = 1000;
+
+struct Vertex {
+    glm::vec2 pos;
+    glm::vec3 col;
+};
+
+struct MVP {
+    glm::mat4 model;
+    glm::mat4 view;
+    glm::mat4 proj;
+};
+
+} // namespace
+
+// Checks that the per-frame API does not allocate from the heap: after a warm-up frame, TEST_FRAME_COUNT frames that
+// pace, poll, acquire, allocate uniforms, update a buffer, record, bind, draw, submit and present have to run without
+// a single operator new. Returns 1 and prints the first allocating frame otherwise.
+// usage: oz_frame_allocation_test
+int main() {
+    GraphicsDevice device;
+
+    // the window is never shown, it still owns the swap chain the frames are presented to
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    Window window = device.createWindow(800, 600, "oz_frame_allocation_test");
+
+    Shader vertShader = device.createShader("uniform.vert", ShaderStage::Vertex);
+    Shader fragShader = device.createShader("default.frag", ShaderStage::Fragment);
+
+    const Vertex   vertices[] = {{{-0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}},
+                                 {{0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}},
+                                 {{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
+                                 {{-0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}}};
+    const uint16_t indices[]  = {0, 1, 2, 2, 3, 0};
+
+    Buffer vertexBuffer = device.createBuffer(BufferType::Vertex, sizeof(vertices));
+    device.uploadBuffer(vertexBuffer, vertices, sizeof(vertices));
+    Buffer indexBuffer = device.createBuffer(BufferType::Index, sizeof(indices));
+    device.uploadBuffer(indexBuffer, indices, sizeof(indices));
+
+    // updated with updateBuffer every frame, bound through a plain uniform binding
+    Buffer numBuffer   = device.createBuffer(BufferType::Uniform, sizeof(uint32_t));
+    Buffer uniformRing = device.getUniformRing();
+
+    DescriptorSetLayout mvpLayout   = device.createDescriptorSetLayout(DescriptorSetLayoutInfo({
+        DescriptorSetLayoutBindingInfo(BindingType::UniformDynamic),
+    }));
+    DescriptorSetLayout countLayout = device.createDescriptorSetLayout(DescriptorSetLayoutInfo({
+        DescriptorSetLayoutBindingInfo(BindingType::UniformDynamic),
+        DescriptorSetLayoutBindingInfo(BindingType::Uniform),
+    }));
+
+    DescriptorSet mvpSet   = device.createDescriptorSet(mvpLayout,
+                                                      DescriptorSetInfo({
+                                                          DescriptorSetBindingInfo(DescriptorSetBufferInfo(uniformRing, sizeof(MVP))),
+                                                      }));
+    DescriptorSet countSet = device.createDescriptorSet(countLayout,
+                                                        DescriptorSetInfo({
+                                                            DescriptorSetBindingInfo(DescriptorSetBufferInfo(uniformRing, sizeof(uint32_t))),
+                                                            DescriptorSetBindingInfo(DescriptorSetBufferInfo(numBuffer, sizeof(uint32_t))),
+                                                        }));
+
+    RenderPass renderPass = device.createRenderPass(vertShader,
+                                                    fragShader,
+                                                    window,
+                                                    VertexLayoutInfo(sizeof(Vertex),
+                                                                     {VertexLayoutAttributeInfo(offsetof(Vertex, pos), Format::R32G32_SFLOAT),
+                                                                      VertexLayoutAttributeInfo(offsetof(Vertex, col), Format::R32G32B32_SFLOAT)}),
+                                                    {mvpLayout, countLayout});
+
+    RenderQueue renderQueue;
+
+    DrawPacket quad;
+    quad.pipeline     = renderPass;
+    quad.material     = mvpSet;
+    quad.vertexBuffer = vertexBuffer;
+    quad.indexBuffer  = indexBuffer;
+    quad.count        = 6;
+
+    uint64_t firstAllocatingFrame = 0;
+    uint64_t allocationCount      = 0;
+    for (uint32_t frame = 0; frame < WARM_UP_FRAME_COUNT + TEST_FRAME_COUNT; frame++) {
+        const uint64_t frameStartCount = s_allocationCount.load(std::memory_order_relaxed);
+
+        device.paceFrame();
+        device.pollEvents();
+
+        uint32_t      imageIndex = device.getCurrentImage(window);
+        CommandBuffer cmd        = device.getCurrentCommandBuffer();
+
+        MVP mvp{};
+        mvp.model           = glm::mat4(1.0f);
+        mvp.view            = glm::mat4(1.0f);
+        mvp.proj            = glm::mat4(1.0f);
+        quad.materialOffset = device.pushUniform(mvp);
+
+        const uint32_t countOffset = device.pushUniform(frame);
+        device.updateBuffer(numBuffer, &frame, sizeof(frame));
+
+        device.beginCmd(cmd);
+        device.beginRenderPass(cmd, renderPass, imageIndex);
+        device.bindDescriptorSet(cmd, renderPass, countSet, 1, {countOffset});
+
+        renderQueue.clear();
+        renderQueue.push(0, 0.5f, quad);
+        renderQueue.sort();
+        renderQueue.record(device, cmd);
+
+        device.endRenderPass(cmd);
+        device.endCmd(cmd);
+        device.submitCmd(cmd);
+        device.presentFrame();
+
+        const uint64_t frameAllocationCount = s_allocationCount.load(std::memory_order_relaxed) - frameStartCount;
+        if (frame >= WARM_UP_FRAME_COUNT && frameAllocationCount > 0) {
+            if (allocationCount == 0) {
+                firstAllocatingFrame = frame;
+            }
+            allocationCount += frameAllocationCount;
+        }
+    }
+
+    device.free(vertShader);
+    device.free(fragShader);
+    device.free(window);
+    device.free(renderPass);
+    device.free(mvpLayout);
+    device.free(countLayout);
+    device.free(vertexBuffer);
+    device.free(indexBuffer);
+    device.free(numBuffer);
+
+    if (allocationCount > 0) {
+        std::printf("FAILED: %llu operator new call(s) in %u frames, the first in frame %llu\n",
+                    static_cast<unsigned long long>(allocationCount),
+                    TEST_FRAME_COUNT,
+                    static_cast<unsigned long long>(firstAllocatingFrame));
+        return 1;
+    }
+    std::printf("PASSED: no operator new call in %u frames after %u warm-up frame(s)\n", TEST_FRAME_COUNT, WARM_UP_FRAME_COUNT);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "oz/asset/importer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace oz::asset;
+
+namespace {
+
+static constexpr uint32_t DEFAULT_RUN_COUNT = 5;
+
+struct Result {
+    ImportStats best;    // run with the highest throughput
+    ImportStats average; // stage timings averaged over the runs
+    size_t      vertexCount = 0;
+    size_t      indexCount  = 0;
+};
+
+// one warm-up import, so the file is in the page cache and the job system is running, then runCount timed imports
+Result benchmark(const std::string& path, const ImportSettings& settings, uint32_t runCount) {
+    Result result;
+
+    MeshData mesh      = importMesh(path, settings);
+    result.vertexCount = mesh.vertices.size();
+    result.indexCount  = mesh.indices.size();
+
+    for (uint32_t run = 0; run < runCount; run++) {
+        ImportStats stats;
+        importMesh(path, settings, &stats);
+
+        if (run == 0 || stats.getMegabytesPerSecond() > result.best.getMegabytesPerSecond()) {
+            result.best = stats;
+        }
+        result.average.sourceSize = stats.sourceSize;
+        result.average.readSeconds += stats.readSeconds / runCount;
+        result.average.parseSeconds += stats.parseSeconds / runCount;
+        result.average.optimizeSeconds += stats.optimizeSeconds / runCount;
+    }
+    return result;
+}
+
+void printResult(const char* mode, const Result& result) {
+    const ImportStats& average = result.average;
+    std::printf("  %-14s read %9.3f ms  parse %9.3f ms  optimize %9.3f ms  average %8.1f MB/s  best %8.1f MB/s\n",
+                mode,
+                average.readSeconds * 1000.0,
+                average.parseSeconds * 1000.0,
+                average.optimizeSeconds * 1000.0,
+                average.getMegabytesPerSecond(),
+                result.best.getMegabytesPerSecond());
+}
+
+} // namespace
+
+// Measures the import throughput of OBJ and GLB files, source megabytes over the time to read, parse and optimize.
+// Every file is imported as parsing only and with the default optimization and LOD generation.
+// usage: oz_import_benchmark [--runs <count>] [--threads <count>] <mesh file>...
+int main(int argc, char** argv) {
+    uint32_t                 runCount    = DEFAULT_RUN_COUNT;
+    uint32_t                 threadCount = 0;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runCount = std::max(1u, static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10)));
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        std::fprintf(stderr, "usage: oz_import_benchmark [--runs <count>] [--threads <count>] <mesh file>...\n");
+        return 1;
+    }
+
+    ImportSettings parseOnly;
+    parseOnly.threadCount  = threadCount;
+    parseOnly.optimize     = false;
+    parseOnly.generateLods = false;
+
+    ImportSettings full;
+    full.threadCount = threadCount;
+
+    for (const std::string& path : paths) {
+        try {
+            const Result parseResult = benchmark(path, parseOnly, runCount);
+            const Result fullResult  = benchmark(path, full, runCount);
+
+            std::printf("%s: %.2f MB, %zu vertices, %zu indices after optimization, %u run(s)\n",
+                        path.c_str(),
+                        parseResult.average.sourceSize / (1024.0 * 1024.0),
+                        fullResult.vertexCount,
+                        fullResult.indexCount,
+                        runCount);
+            printResult("parse only", parseResult);
+            printResult("full import", fullResult);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: %s\n", path.c_str(), e.what());
+            return 1;
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "oz/core/job/job_system.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace oz::job;
+
+namespace {
+
+static constexpr uint32_t BATCH_SIZE   = 1024; // jobs per run call, a quarter of the deque capacity
+static constexpr uint32_t BATCH_COUNT  = 1000;
+static constexpr uint32_t CHAIN_LENGTH = 10000; // batches of one job, each depending on the previous one
+
+using Clock = std::chrono::steady_clock;
+
+void emptyJob(void*, uint32_t, uint32_t) {}
+
+void printResult(const char* name, Clock::duration duration, uint64_t jobCount) {
+    const double ns = std::chrono::duration<double, std::nano>(duration).count();
+    std::printf("%-40s %10llu jobs %10.1f ns/job\n", name, static_cast<unsigned long long>(jobCount), ns / double(jobCount));
+}
+
+// batches submitted by the main thread and waited on, the waiting main thread takes part
+Clock::duration runBatches(JobSystem& jobSystem, uint32_t batchCount) {
+    Job jobs[BATCH_SIZE];
+    for (Job& job : jobs) {
+        job.function = &emptyJob;
+    }
+
+    const auto start = Clock::now();
+    for (uint32_t batch = 0; batch < batchCount; batch++) {
+        Counter counter;
+        jobSystem.run(jobs, BATCH_SIZE, counter);
+        jobSystem.wait(counter);
+    }
+    return Clock::now() - start;
+}
+
+// every job pushes the next one, so the jobs are spread by stealing instead of by the submitting thread
+struct SpawnContext {
+    JobSystem* jobSystem;
+    Counter*   counter;
+};
+
+void spawnJob(void* data, uint32_t begin, uint32_t end) {
+    if (begin + 1 < end) {
+        SpawnContext& context = *static_cast<SpawnContext*>(data);
+
+        Job next;
+        next.function = &spawnJob;
+        next.data     = data;
+        next.begin    = begin + 1;
+        next.end      = end;
+        context.jobSystem->run(next, *context.counter);
+    }
+}
+
+Clock::duration runSpawnChains(JobSystem& jobSystem, uint32_t chainCount, uint32_t chainLength) {
+    Counter      counter;
+    SpawnContext context{&jobSystem, &counter};
+
+    Job job;
+    job.function = &spawnJob;
+    job.data     = &context;
+    job.begin    = 0;
+    job.end      = chainLength;
+
+    const auto start = Clock::now();
+    for (uint32_t chain = 0; chain < chainCount; chain++) {
+        jobSystem.run(job, counter);
+    }
+    jobSystem.wait(counter);
+    return Clock::now() - start;
+}
+
+// batches of one job that depend on the previous batch, measures the continuation path
+Clock::duration runDependencies(JobSystem& jobSystem, uint32_t length) {
+    std::vector<Counter> counters(length);
+
+    Job job;
+    job.function = &emptyJob;
+
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < length; i++) {
+        jobSystem.run(job, counters[i], i > 0 ? &counters[i - 1] : nullptr);
+    }
+    jobSystem.wait(counters.back());
+    return Clock::now() - start;
+}
+
+// ranges of a single item, the smallest ranges parallelFor splits into
+Clock::duration runParallelFor(JobSystem& jobSystem, uint32_t count) {
+    const auto start = Clock::now();
+    jobSystem.parallelFor(count, 1, count, [](uint32_t, uint32_t) {});
+    return Clock::now() - start;
+}
+
+} // namespace
+
+// Measures the scheduling overhead of the job system with jobs that do no work, so the time per job is the cost to
+// submit, execute and complete it. Every case runs a warm-up round before it is timed.
+// usage: oz_job_benchmark [worker count, 0 picks the hardware concurrency]
+int main(int argc, char** argv) {
+    const uint32_t workerCount = argc > 1 ? static_cast<uint32_t>(std::strtoul(argv[1], nullptr, 10)) : 0;
+
+    JobSystem jobSystem(workerCount);
+    std::printf("job system with %u worker(s), the main thread included\n", jobSystem.getWorkerCount());
+
+    runBatches(jobSystem, BATCH_COUNT / 10);
+    printResult("run and wait, batches of 1024", runBatches(jobSystem, BATCH_COUNT), uint64_t(BATCH_SIZE) * BATCH_COUNT);
+
+    const uint32_t chainCount = jobSystem.getWorkerCount();
+    runSpawnChains(jobSystem, chainCount, CHAIN_LENGTH / 10);
+    printResult("jobs spawning jobs, one chain per worker", runSpawnChains(jobSystem, chainCount, CHAIN_LENGTH), uint64_t(chainCount) * CHAIN_LENGTH);
+
+    runDependencies(jobSystem, CHAIN_LENGTH / 10);
+    printResult("dependent batches of one job", runDependencies(jobSystem, CHAIN_LENGTH), CHAIN_LENGTH);
+
+    runParallelFor(jobSystem, BATCH_SIZE);
+    Clock::duration parallelForDuration{};
+    for (uint32_t i = 0; i < BATCH_COUNT; i++) {
+        parallelForDuration += runParallelFor(jobSystem, BATCH_SIZE);
+    }
+    printResult("parallelFor, ranges of one item", parallelForDuration, uint64_t(BATCH_SIZE) * BATCH_COUNT);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "oz/oz.h"
+using namespace oz::gfx::vk;
+
+// Replays a capture written by a GraphicsDevice created with a CaptureInfo or the OZ_CAPTURE_PATH environment variable.
+// Frames are replayed back to back without pacing, the CPU and GPU time of every frame is printed.
+// usage: oz_replay <capture file>
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: oz_replay <capture file>\n";
+        return 1;
+    }
+    if (std::getenv("OZ_CAPTURE_PATH") != nullptr) {
+        std::cerr << "OZ_CAPTURE_PATH is set, the replay would overwrite the capture\n";
+        return 1;
+    }
+
+    GraphicsDevice device;
+
+    // the captured windows are created hidden, they still own the swap chains the frames are presented to
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    CaptureReplayer replayer(device, argv[1]);
+    std::cout << "Replaying " << replayer.getFrameCount() << " frame(s) of " << argv[1] << "\n";
+
+    // cpu time excludes the waits for the frame in flight and the swap chain, so it is the time spent recording
+    std::vector<double> cpuMs;
+    std::vector<double> gpuMs;
+    while (true) {
+        const auto start    = std::chrono::steady_clock::now();
+        const bool isReplay = replayer.replayFrame();
+        const auto end      = std::chrono::steady_clock::now();
+        if (!isReplay) {
+            break;
+        }
+
+        const FrameTimingStats& timing = device.getFrameTimingStats();
+        cpuMs.push_back(std::chrono::duration<double, std::milli>(end - start).count() - timing.waitMs);
+        gpuMs.push_back(timing.gpuMs);
+    }
+
+    // the GPU time of a frame is read when its frame in flight begins again, an empty frame collects the last one
+    device.beginFrame();
+    device.presentFrame();
+    gpuMs.push_back(device.getFrameTimingStats().gpuMs);
+    gpuMs.erase(gpuMs.begin());
+
+    std::cout << "frame     cpu ms     gpu ms\n";
+    for (size_t i = 0; i < cpuMs.size(); i++) {
+        std::printf("%5zu %10.3f %10.3f\n", i, cpuMs[i], gpuMs[i]);
+    }
+
+    // the first frame also creates the resources of the capture
+    if (cpuMs.size() > 1) {
+        double cpuTotal = 0.0, gpuTotal = 0.0, cpuMax = 0.0, gpuMax = 0.0;
+        for (size_t i = 1; i < cpuMs.size(); i++) {
+            cpuTotal += cpuMs[i];
+            gpuTotal += gpuMs[i];
+            cpuMax = std::max(cpuMax, cpuMs[i]);
+            gpuMax = std::max(gpuMax, gpuMs[i]);
+        }
+        const double frameCount = double(cpuMs.size() - 1);
+        std::printf("average (without frame 0): cpu %.3f ms, gpu %.3f ms\n", cpuTotal / frameCount, gpuTotal / frameCount);
+        std::printf("max     (without frame 0): cpu %.3f ms, gpu %.3f ms\n", cpuMax, gpuMax);
+    }
+
+    return 0;
+}
\ No newline at end of file